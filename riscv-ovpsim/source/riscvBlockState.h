@@ -19,6 +19,9 @@
 
 #pragma once
 
+// VMI header files
+#include "vmi/vmiTypes.h"
+
 // model header files
 #include "riscvTypes.h"
 #include "riscvTypeRefs.h"
@@ -84,6 +87,31 @@ typedef enum riscvPMKE {
     PMK_TRANSACTION = 0x8000,
 } riscvPMK;
 
+//
+// This indicates the kind of result known to have been written by the
+// preceding instruction in a block (used for instruction pair fusion)
+//
+typedef enum riscvFuseKindE {
+    RVFK_NONE,          // no known result
+    RVFK_CONST,         // GPR holds a known constant (e.g. lui, auipc)
+    RVFK_SHL,           // GPR holds left-shifted GPR (slli)
+    RVFK_CMP,           // GPR holds result of GPR comparison (slt, sltu)
+} riscvFuseKind;
+
+//
+// This describes the result written by the preceding instruction in a block
+//
+typedef struct riscvFuseInfoS {
+    riscvFuseKind kind;                 // kind of known result
+    vmiCondition  cond;                 // comparison condition (RVFK_CMP)
+    Uns8          bits;                 // operation size
+    Uns8          rd;                   // index of GPR written
+    Uns8          rs1;                  // index of first source GPR
+    Uns8          rs2;                  // index of second source GPR
+    Uns8          shift;                // shift amount (RVFK_SHL)
+    Uns64         value;                // known constant (RVFK_CONST)
+} riscvFuseInfo;
+
 //
 // This structure holds state for a code block as it is morphed
 //
@@ -97,14 +125,24 @@ typedef struct riscvBlockStateS {
     riscvVLClassMt   VLClassMt    :  2; // known active vector VL zero/non-zero/max
     Bool             vtaMt        :  1; // known active vta
     Bool             vmaMt        :  1; // known active vma
+    Bool             VTypeSpecMt  :  1; // vtype speculated within block?
     Bool             VStartZeroMt :  1; // vstart known to be zero?
     Bool             updateFFlags :  1; // whether to update fflags from fflags_i
+    Bool             FFlagsIZero  :  1; // is fflags_i known to be zero?
     Bool             doLSTrig     :  1; // whether load/store triggers enabled
     Bool             ZfhminOK     :  1; // whether allowed by Zfhmin
     Bool             ZfbfminOK    :  1; // whether allowed by Zfbfmin
     Bool             ZvfbfwmaOK   :  1; // whether allowed by Zvfbfwma
     Bool             FSDirty      :  1; // is status.FS known to be dirty?
     Bool             VSDirty      :  1; // is status.VS known to be dirty?
+    Bool             countBlock   :  1; // whether block count not yet emitted
+    Bool             flushCycles  :  1; // whether cycle flush not yet emitted
+    Bool             sampleBlock  :  1; // whether cache sampling not yet emitted
+    Uns16            pmKeyMt;           // speculated polymorphic key
+    riscvFuseInfo    fusePrev;          // result of previous instruction
+    riscvFuseInfo    fuseNext;          // result of current instruction
+    riscvBlockEntryP profileBlock;      // profile entry for block (if any)
+    Uns64            fetchLine;         // instruction cache line last fetched
 
 } riscvBlockState;
 
@@ -0,0 +1,990 @@
+/*
+ * Copyright (c) 2005-2023 Imperas Software Ltd., www.imperas.com
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Standard header files
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Imperas header files
+#include "hostapi/impAlloc.h"
+
+// VMI header files
+#include "vmi/vmiCommand.h"
+#include "vmi/vmiMessage.h"
+#include "vmi/vmiMt.h"
+#include "vmi/vmiRt.h"
+
+// model header files
+#include "riscvBranch.h"
+#include "riscvMessage.h"
+#include "riscvStructure.h"
+#include "riscvTiming.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+// TYPES
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Name of branch statistics command
+//
+#define BRANCH_STATS_NAME "branchStatistics"
+
+//
+// Number of sites shown by the branchStatistics command
+//
+#define BRANCH_STATS_SHOW 16
+
+//
+// Number of entries in branch site hash table
+//
+#define SITE_HASH_SIZE 1024
+
+//
+// Number of TAGE tagged components and their global history lengths
+//
+#define TAGE_TABLES 4
+static const Uns32 tageHistory[TAGE_TABLES] = {4, 8, 16, 32};
+
+//
+// Direction predictor type
+//
+typedef enum riscvPredictorTypeE {
+    RVBP_BIMODAL,       // PC-indexed two-bit counters
+    RVBP_GSHARE,        // PC xor global history indexed two-bit counters
+    RVBP_TAGE,          // bimodal base with tagged geometric-history tables
+    RVBP_LAST           // KEEP LAST: for sizing
+} riscvPredictorType;
+
+//
+// Direction predictor type names
+//
+static const char *typeNames[RVBP_LAST] = {
+    [RVBP_BIMODAL] = "bimodal",
+    [RVBP_GSHARE]  = "gshare",
+    [RVBP_TAGE]    = "tage",
+};
+
+//
+// Branch kind
+//
+typedef enum riscvBranchKindE {
+    RVBK_COND,          // conditional branch
+    RVBK_JUMP,          // direct jump
+    RVBK_CALL,          // call (direct or indirect)
+    RVBK_RETURN,        // return
+    RVBK_INDIRECT,      // other indirect jump
+    RVBK_LAST           // KEEP LAST: for sizing
+} riscvBranchKind;
+
+//
+// Branch kind names
+//
+static const char *kindNames[RVBK_LAST] = {
+    [RVBK_COND]     = "conditional",
+    [RVBK_JUMP]     = "jump",
+    [RVBK_CALL]     = "call",
+    [RVBK_RETURN]   = "return",
+    [RVBK_INDIRECT] = "indirect",
+};
+
+//
+// This is a branch site (one per branch instruction address and kind)
+//
+typedef struct riscvBranchSiteS {
+    riscvBranchSiteP next;          // next site in hash bucket
+    Uns64            PC;            // branch address
+    Uns64            target;        // constant target address (if direct)
+    Uns64            linkPC;        // link address (if call)
+    Uns64            executed;      // times executed
+    Uns64            taken;         // times taken
+    Uns64            mispredicts;   // times mispredicted
+    riscvBranchKind  kind;          // branch kind
+} riscvBranchSite;
+
+//
+// This is a branch target buffer entry
+//
+typedef struct riscvBTBEntryS {
+    Uns64 PC;                       // branch address
+    Uns64 target;                   // predicted target
+} riscvBTBEntry;
+
+//
+// This is a TAGE tagged component entry
+//
+typedef struct riscvTageEntryS {
+    Uns8 tag;                       // partial tag
+    Int8 ctr;                       // signed 3-bit direction counter
+    Uns8 u;                         // 2-bit usefulness counter
+    Bool valid;                     // whether entry allocated
+} riscvTageEntry;
+
+//
+// This holds branch predictor state for a hart
+//
+typedef struct riscvBranchModelS {
+
+    // configuration
+    riscvPredictorType type;                // direction predictor type
+    Uns32              entries;             // counter table entries
+    Uns32              historyBits;         // gshare global history bits
+    Uns32              btbEntries;          // BTB entries
+    Uns32              rasDepth;            // return address stack depth
+    Uns32              penalty;             // misprediction penalty cycles
+
+    // predictor state
+    Uns64              history;             // global branch history
+    Uns8              *counters;            // two-bit counters
+    riscvTageEntryP    tage[TAGE_TABLES];   // TAGE tagged components
+    Uns32              tageEntries;         // entries in each tagged component
+    riscvBTBEntryP     btb;                 // branch target buffer
+    Uns64             *ras;                 // return address stack
+    Uns32              rasTop;              // index of next free RAS entry
+    Uns32              rasValid;            // valid RAS entries
+
+    // statistics
+    riscvBranchSiteP   sites[SITE_HASH_SIZE];
+    Uns32              siteNum;
+    Uns64              executed[RVBK_LAST];
+    Uns64              mispredicts[RVBK_LAST];
+
+} riscvBranchModel;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// CONFIGURATION
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Is the value a non-zero power of two?
+//
+inline static Bool isPowerOfTwo(Uns64 value) {
+    return value && !(value & (value-1));
+}
+
+//
+// Return the predictor type with the given name (of the given length), or
+// RVBP_LAST if there is none
+//
+static riscvPredictorType findType(const char *name, Uns32 length) {
+
+    riscvPredictorType type;
+
+    for(type=0; type<RVBP_LAST; type++) {
+        if((strlen(typeNames[type])==length) && !strncmp(typeNames[type], name, length)) {
+            break;
+        }
+    }
+
+    return type;
+}
+
+//
+// Parse a branch predictor specification of the form "key=value,..." with keys
+// type (bimodal, gshare or tage), entries, history, btb, ras and penalty,
+// returning False if it is malformed
+//
+static Bool parseBranch(riscvBranchModelP model, const char *spec) {
+
+    const char *s = spec;
+
+    while(*s) {
+
+        const char *eq    = strchr(s, '=');
+        const char *value = eq ? eq+1 : 0;
+        const char *end   = value ? strchr(value, ',') : 0;
+        Uns32       keyLength;
+        Uns32       valueLength;
+        char       *numEnd;
+        Uns64       num;
+
+        if(!eq) {
+            return False;
+        }
+
+        if(!end) {
+            end = value+strlen(value);
+        }
+
+        keyLength   = eq-s;
+        valueLength = end-value;
+
+        if((keyLength==4) && !strncmp(s, "type", 4)) {
+
+            if((model->type=findType(value, valueLength))==RVBP_LAST) {
+                return False;
+            }
+
+        } else {
+
+            num = strtoull(value, &numEnd, 0);
+
+            if((numEnd==value) || (numEnd!=end)) {
+                return False;
+            } else if((keyLength==7) && !strncmp(s, "entries", 7)) {
+                model->entries = num;
+            } else if((keyLength==7) && !strncmp(s, "history", 7)) {
+                model->historyBits = num;
+            } else if((keyLength==3) && !strncmp(s, "btb", 3)) {
+                model->btbEntries = num;
+            } else if((keyLength==3) && !strncmp(s, "ras", 3)) {
+                model->rasDepth = num;
+            } else if((keyLength==7) && !strncmp(s, "penalty", 7)) {
+                model->penalty = num;
+            } else {
+                return False;
+            }
+        }
+
+        s = *end ? end+1 : end;
+    }
+
+    return True;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DIRECTION PREDICTION
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Update a saturating two-bit counter
+//
+inline static void updateCounter(Uns8 *counter, Bool taken) {
+    if(taken) {
+        if(*counter<3) (*counter)++;
+    } else {
+        if(*counter>0) (*counter)--;
+    }
+}
+
+//
+// Return the counter table index for the branch address
+//
+inline static Uns32 getPCIndex(riscvBranchModelP model, Uns64 PC) {
+    return (PC>>1) & (model->entries-1);
+}
+
+//
+// Fold the given length of global history into the given number of bits
+//
+static Uns32 foldHistory(Uns64 history, Uns32 length, Uns32 bits) {
+
+    Uns32 result = 0;
+
+    if(length<64) {
+        history &= (1ULL<<length)-1;
+    }
+
+    while(bits && history) {
+        result  ^= history & ((1ULL<<bits)-1);
+        history >>= bits;
+    }
+
+    return result;
+}
+
+//
+// Predict and update a two-bit counter predictor (bimodal or gshare)
+//
+static Bool predictCounter(riscvBranchModelP model, Uns64 PC, Bool taken) {
+
+    Uns32 index = getPCIndex(model, PC);
+
+    if(model->type==RVBP_GSHARE) {
+
+        Uns32 indexBits = __builtin_ctz(model->entries);
+
+        index ^= foldHistory(model->history, model->historyBits, indexBits);
+    }
+
+    Uns8 *counter = &model->counters[index];
+    Bool  predict = (*counter>=2);
+
+    updateCounter(counter, taken);
+
+    return predict;
+}
+
+//
+// Predict and update a TAGE-lite predictor: a bimodal base predictor with
+// TAGE_TABLES partially-tagged components indexed using geometrically
+// increasing global history lengths. The longest matching component provides
+// the prediction; on a misprediction an entry is allocated in a longer
+// component if one is not useful.
+//
+static Bool predictTAGE(riscvBranchModelP model, Uns64 PC, Bool taken) {
+
+    Uns32           indexBits = __builtin_ctz(model->tageEntries);
+    Uns32           pcIndex   = getPCIndex(model, PC);
+    Uns8           *base      = &model->counters[pcIndex];
+    Bool            basePred  = (*base>=2);
+    Bool            altPred   = basePred;
+    Bool            predict   = basePred;
+    Int32           provider  = -1;
+    Int32           alt       = -1;
+    riscvTageEntryP entry[TAGE_TABLES];
+    Uns8            tag[TAGE_TABLES];
+    Int32           i;
+
+    // find provider (longest match) and alternate components
+    for(i=TAGE_TABLES-1; i>=0; i--) {
+
+        Uns32 length = tageHistory[i];
+        Uns32 index  = ((PC>>1) ^ foldHistory(model->history, length, indexBits));
+
+        entry[i] = &model->tage[i][index & (model->tageEntries-1)];
+        tag[i]   = (PC>>1) ^ foldHistory(model->history, length, 8) ^ (i<<6);
+
+        if(!entry[i]->valid || (entry[i]->tag!=tag[i])) {
+            // no match
+        } else if(provider<0) {
+            provider = i;
+        } else if(alt<0) {
+            alt = i;
+        }
+    }
+
+    if(alt>=0) {
+        altPred = (entry[alt]->ctr>=0);
+    }
+
+    if(provider<0) {
+
+        // base predictor provides prediction
+        updateCounter(base, taken);
+
+    } else {
+
+        riscvTageEntryP p = entry[provider];
+
+        predict = (p->ctr>=0);
+
+        // update usefulness when provider and alternate disagree
+        if(predict!=altPred) {
+            if(predict==taken) {
+                if(p->u<3) p->u++;
+            } else {
+                if(p->u>0) p->u--;
+            }
+        }
+
+        // update provider direction counter
+        if(taken) {
+            if(p->ctr<3) p->ctr++;
+        } else {
+            if(p->ctr>-4) p->ctr--;
+        }
+    }
+
+    // allocate in a longer component on misprediction
+    if((predict!=taken) && (provider<TAGE_TABLES-1)) {
+
+        Bool allocated = False;
+
+        for(i=provider+1; !allocated && (i<TAGE_TABLES); i++) {
+
+            if(!entry[i]->valid || !entry[i]->u) {
+                entry[i]->valid = True;
+                entry[i]->tag   = tag[i];
+                entry[i]->ctr   = taken ? 0 : -1;
+                entry[i]->u     = 0;
+                allocated       = True;
+            }
+        }
+
+        // age candidates if none could be allocated
+        for(i=provider+1; !allocated && (i<TAGE_TABLES); i++) {
+            entry[i]->u--;
+        }
+    }
+
+    return predict;
+}
+
+//
+// Predict and update direction of a conditional branch
+//
+static Bool predictDirection(riscvBranchModelP model, Uns64 PC, Bool taken) {
+
+    Bool predict;
+
+    if(model->type==RVBP_TAGE) {
+        predict = predictTAGE(model, PC, taken);
+    } else {
+        predict = predictCounter(model, PC, taken);
+    }
+
+    model->history = (model->history<<1) | taken;
+
+    return predict;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// TARGET PREDICTION
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Look up the BTB for a taken branch, returning True if it predicts the given
+// target, and update it
+//
+static Bool checkBTB(riscvBranchModelP model, Uns64 PC, Uns64 target) {
+
+    riscvBTBEntryP entry = &model->btb[(PC>>1) & (model->btbEntries-1)];
+    Bool           hit   = (entry->PC==PC) && (entry->target==target);
+
+    entry->PC     = PC;
+    entry->target = target;
+
+    return hit;
+}
+
+//
+// Push a return address on the return address stack (overwriting the oldest
+// entry if it is full)
+//
+static void pushRAS(riscvBranchModelP model, Uns64 linkPC) {
+
+    if(model->rasDepth) {
+
+        model->ras[model->rasTop] = linkPC;
+        model->rasTop = (model->rasTop+1) % model->rasDepth;
+
+        if(model->rasValid<model->rasDepth) {
+            model->rasValid++;
+        }
+    }
+}
+
+//
+// Pop a return address from the return address stack, returning True if it
+// matches the actual target
+//
+static Bool popRAS(riscvBranchModelP model, Uns64 target) {
+
+    Bool hit = False;
+
+    if(model->rasValid) {
+        model->rasTop = (model->rasTop+model->rasDepth-1) % model->rasDepth;
+        hit = (model->ras[model->rasTop]==target);
+        model->rasValid--;
+    }
+
+    return hit;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// SIMULATION
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Record branch outcome
+//
+static void recordOutcome(
+    riscvP           riscv,
+    riscvBranchSiteP site,
+    Bool             taken,
+    Bool             mispredict
+) {
+    riscvBranchModelP model = riscv->branch;
+
+    site->executed++;
+    site->taken += taken;
+
+    model->executed[site->kind]++;
+
+    riscv->hpmEvents[RVHE_BRANCH]++;
+
+    if(mispredict) {
+
+        site->mispredicts++;
+        model->mispredicts[site->kind]++;
+
+        riscv->hpmEvents[RVHE_BRANCH_MISS]++;
+
+        if(model->penalty) {
+            riscvAddPendingCycles(riscv, model->penalty);
+        }
+    }
+}
+
+//
+// Simulate conditional branch
+//
+static void conditionalCB(riscvP riscv, riscvBranchSiteP site, Bool taken) {
+
+    riscvBranchModelP model      = riscv->branch;
+    Bool              mispredict = predictDirection(model, site->PC, taken)!=taken;
+
+    // a taken branch also requires the BTB to supply the target
+    if(taken && !checkBTB(model, site->PC, site->target)) {
+        mispredict = True;
+    }
+
+    recordOutcome(riscv, site, taken, mispredict);
+}
+
+//
+// Simulate unconditional jump
+//
+static void jumpCB(riscvP riscv, riscvBranchSiteP site, Uns64 target) {
+
+    riscvBranchModelP model = riscv->branch;
+    Bool              mispredict;
+
+    // jalr clears bit 0 of the target address
+    target &= -2;
+
+    if(site->kind==RVBK_RETURN) {
+        mispredict = !popRAS(model, target);
+    } else {
+        mispredict = !checkBTB(model, site->PC, target);
+    }
+
+    if(site->kind==RVBK_CALL) {
+        pushRAS(model, site->linkPC);
+    }
+
+    recordOutcome(riscv, site, True, mispredict);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// CODE GENERATION
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Find or create the site for a branch at the current address (sites are
+// shared if a block is translated again)
+//
+static riscvBranchSiteP getSite(
+    riscvBranchModelP model,
+    Uns64             PC,
+    riscvBranchKind   kind,
+    Uns64             target,
+    Uns64             linkPC
+) {
+    riscvBranchSiteP *bucket = &model->sites[(PC>>1) & (SITE_HASH_SIZE-1)];
+    riscvBranchSiteP  site;
+
+    for(site=*bucket; site; site=site->next) {
+        if((site->PC==PC) && (site->kind==kind) && (site->target==target)) {
+            return site;
+        }
+    }
+
+    site = STYPE_CALLOC(riscvBranchSite);
+
+    site->next   = *bucket;
+    site->PC     = PC;
+    site->kind   = kind;
+    site->target = target;
+    site->linkPC = linkPC;
+    *bucket      = site;
+
+    model->siteNum++;
+
+    return site;
+}
+
+//
+// Emit code to simulate prediction of a conditional branch to the given target
+// if branch prediction is enabled (taken is a register holding the branch
+// condition)
+//
+void riscvEmitBranchConditional(riscvP riscv, Uns64 tgt, vmiReg taken) {
+
+    riscvBranchModelP model = riscv->branch;
+
+    if(model) {
+
+        Uns64            PC   = vmirtGetPC((vmiProcessorP)riscv);
+        riscvBranchSiteP site = getSite(model, PC, RVBK_COND, tgt, 0);
+
+        // transfer pending cycles if mispredictions add cycles
+        if(model->penalty) {
+            riscvEmitTimingFlush(riscv);
+        }
+
+        vmimtArgProcessor();
+        vmimtArgNatAddress(site);
+        vmimtArgReg(8, taken);
+        vmimtCall((vmiCallFn)conditionalCB);
+    }
+}
+
+//
+// Emit code to simulate prediction of an unconditional jump if branch
+// prediction is enabled. If ra is VMI_NOREG, the jump target is the constant
+// tgt; otherwise it is given by register ra of the given size. isIndirect
+// indicates a jump using a register target (jalr) and hint indicates a call or
+// return.
+//
+void riscvEmitBranchJump(
+    riscvP      riscv,
+    vmiReg      ra,
+    Uns32       bits,
+    Uns64       tgt,
+    Uns64       linkPC,
+    vmiJumpHint hint,
+    Bool        isIndirect
+) {
+    riscvBranchModelP model = riscv->branch;
+
+    if(model) {
+
+        Uns64            PC = vmirtGetPC((vmiProcessorP)riscv);
+        riscvBranchKind  kind;
+        riscvBranchSiteP site;
+
+        if(hint & vmi_JH_RETURN) {
+            kind = RVBK_RETURN;
+        } else if(hint & vmi_JH_CALL) {
+            kind = RVBK_CALL;
+        } else if(isIndirect) {
+            kind = RVBK_INDIRECT;
+        } else {
+            kind = RVBK_JUMP;
+        }
+
+        site = getSite(model, PC, kind, VMI_ISNOREG(ra) ? tgt : 0, linkPC);
+
+        // transfer pending cycles if mispredictions add cycles
+        if(model->penalty) {
+            riscvEmitTimingFlush(riscv);
+        }
+
+        vmimtArgProcessor();
+        vmimtArgNatAddress(site);
+
+        if(VMI_ISNOREG(ra)) {
+            vmimtArgUns64(tgt);
+        } else {
+            vmimtArgRegSimAddress(bits, ra);
+        }
+
+        vmimtCall((vmiCallFn)jumpCB);
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// REPORTING
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Compare branch sites by descending mispredictions, then address
+//
+static Int32 compareBranchSite(const void *va, const void *vb) {
+
+    riscvBranchSiteP a = *(riscvBranchSiteP *)va;
+    riscvBranchSiteP b = *(riscvBranchSiteP *)vb;
+
+    if(a->mispredicts>b->mispredicts) {
+        return -1;
+    } else if(a->mispredicts<b->mispredicts) {
+        return 1;
+    } else if(a->PC<b->PC) {
+        return -1;
+    } else {
+        return (a->PC>b->PC);
+    }
+}
+
+//
+// Return misprediction rate as a percentage
+//
+inline static double getRate(Uns64 mispredicts, Uns64 executed) {
+    return executed ? 100.0*mispredicts/executed : 0;
+}
+
+//
+// Print branch statistics for a hart
+//
+static void dumpBranch(riscvP riscv) {
+
+    riscvBranchModelP model    = riscv->branch;
+    riscvBranchSiteP *sites    = STYPE_CALLOC_N(riscvBranchSiteP, model->siteNum+1);
+    Uns32             siteNum  = 0;
+    Uns64             executed = 0;
+    Uns64             missed   = 0;
+    char              executedString[32];
+    char              missedString[32];
+    riscvBranchKind   kind;
+    riscvBranchSiteP  site;
+    Uns32             i;
+
+    vmiPrintf(
+        "Branch prediction statistics for '%s' (%s, %u entries, %u BTB "
+        "entries, %u RAS entries):\n",
+        vmirtProcessorName((vmiProcessorP)riscv), typeNames[model->type],
+        model->entries, model->btbEntries, model->rasDepth
+    );
+
+    vmiPrintf("  %-12s %16s %16s %8s\n", "kind", "executed", "mispredicted", "rate");
+
+    for(kind=0; kind<RVBK_LAST; kind++) {
+
+        sprintf(executedString, FMT_Au, model->executed[kind]);
+        sprintf(missedString,   FMT_Au, model->mispredicts[kind]);
+
+        vmiPrintf(
+            "  %-12s %16s %16s %7.2f%%\n",
+            kindNames[kind], executedString, missedString,
+            getRate(model->mispredicts[kind], model->executed[kind])
+        );
+
+        executed += model->executed[kind];
+        missed   += model->mispredicts[kind];
+    }
+
+    sprintf(executedString, FMT_Au, executed);
+    sprintf(missedString,   FMT_Au, missed);
+
+    vmiPrintf(
+        "  %-12s %16s %16s %7.2f%%\n",
+        "total", executedString, missedString, getRate(missed, executed)
+    );
+
+    // collect sites with mispredictions
+    for(i=0; i<SITE_HASH_SIZE; i++) {
+        for(site=model->sites[i]; site; site=site->next) {
+            if(site->mispredicts) {
+                sites[siteNum++] = site;
+            }
+        }
+    }
+
+    qsort(sites, siteNum, sizeof(sites[0]), compareBranchSite);
+
+    vmiPrintf("Most mispredicted branches (kind, executed, taken, mispredicted, rate):\n");
+
+    for(i=0; (i<BRANCH_STATS_SHOW) && (i<siteNum); i++) {
+
+        char takenString[32];
+
+        site = sites[i];
+
+        sprintf(executedString, FMT_Au, site->executed);
+        sprintf(takenString,    FMT_Au, site->taken);
+        sprintf(missedString,   FMT_Au, site->mispredicts);
+
+        vmiPrintf(
+            "  0x"FMT_640Nx" %-12s %16s %16s %16s %7.2f%%\n",
+            site->PC, kindNames[site->kind],
+            executedString, takenString, missedString,
+            getRate(site->mispredicts, site->executed)
+        );
+    }
+
+    STYPE_FREE(sites);
+}
+
+//
+// Clear branch statistics for a hart (predictor state is preserved)
+//
+static void resetBranch(riscvP riscv) {
+
+    riscvBranchModelP model = riscv->branch;
+    riscvBranchSiteP  site;
+    Uns32             i;
+
+    for(i=0; i<SITE_HASH_SIZE; i++) {
+        for(site=model->sites[i]; site; site=site->next) {
+            site->executed    = 0;
+            site->taken       = 0;
+            site->mispredicts = 0;
+        }
+    }
+
+    memset(model->executed,    0, sizeof(model->executed));
+    memset(model->mispredicts, 0, sizeof(model->mispredicts));
+}
+
+//
+// Handle dump or reset of branch statistics
+//
+static VMIRT_COMMAND_PARSE_FN(branchStatistics) {
+
+    riscvP       riscv    = (riscvP)processor;
+    vmiArgValueP argDump  = vmirtFindArgValue(argc, argv, "dump");
+    vmiArgValueP argReset = vmirtFindArgValue(argc, argv, "reset");
+    Bool         found    = False;
+
+    // handle "dump" argument
+    if(argDump && argDump->isSet) {
+        dumpBranch(riscv);
+        found = True;
+    }
+
+    // handle "reset" argument
+    if(argReset && argReset->isSet) {
+        resetBranch(riscv);
+        found = True;
+    }
+
+    if(!found) {
+
+        vmiPrintf("%s: -dump -reset\n", BRANCH_STATS_NAME);
+
+        // error status
+        return NULL;
+    }
+
+    return "1";
+}
+
+//
+// Add command for branch statistics dump and reset
+//
+static void addBranchCommand(riscvP riscv) {
+
+    vmiCommandP cmd = vmirtAddCommandParse(
+        (vmiProcessorP)riscv,
+        BRANCH_STATS_NAME,
+        "show or reset branch prediction statistics",
+        branchStatistics,
+        VMI_CT_DEFAULT|VMI_CO_DIAG|VMI_CA_REPORT
+    );
+
+    const char *dumpHelp  = "print misprediction statistics by kind and site";
+    const char *resetHelp = "clear misprediction statistics";
+
+    vmirtAddArg(cmd, "dump",  dumpHelp,  VMI_CA_BOOL, VMI_CAA_DEFAULT, False, 0);
+    vmirtAddArg(cmd, "reset", resetHelp, VMI_CA_BOOL, VMI_CAA_DEFAULT, False, 0);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// INTERFACE ROUTINES
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Allocate branch predictor model and commands for a hart if required
+//
+void riscvNewBranch(riscvP riscv) {
+
+    const char *spec = riscv->branchSpec;
+
+    if(spec && spec[0]) {
+
+        riscvBranchModelP model = STYPE_CALLOC(riscvBranchModel);
+
+        // default configuration
+        model->type        = RVBP_GSHARE;
+        model->entries     = 4096;
+        model->historyBits = 12;
+        model->btbEntries  = 512;
+        model->rasDepth    = 16;
+
+        if(
+            !parseBranch(model, spec) ||
+            !isPowerOfTwo(model->entries) ||
+            !isPowerOfTwo(model->btbEntries) ||
+            (model->historyBits>64)
+        ) {
+            vmiMessage("W", CPU_PREFIX"_IBP",
+                "Invalid branch_predictor specification '%s' - expected "
+                "comma-separated key=value with key one of type (bimodal, "
+                "gshare or tage), entries, history, btb, ras or penalty; "
+                "entries and btb must be powers of two (ignored)",
+                spec
+            );
+
+            STYPE_FREE(model);
+
+        } else {
+
+            Uns32 i;
+
+            // all counters are initially weakly not-taken
+            model->counters = STYPE_CALLOC_N(Uns8, model->entries);
+            memset(model->counters, 1, model->entries);
+
+            // TAGE tagged components are each a quarter of the base size
+            if(model->type==RVBP_TAGE) {
+
+                model->tageEntries = (model->entries>=64) ? model->entries/4 : 16;
+
+                for(i=0; i<TAGE_TABLES; i++) {
+                    model->tage[i] = STYPE_CALLOC_N(riscvTageEntry, model->tageEntries);
+                }
+            }
+
+            model->btb = STYPE_CALLOC_N(riscvBTBEntry, model->btbEntries);
+
+            if(model->rasDepth) {
+                model->ras = STYPE_CALLOC_N(Uns64, model->rasDepth);
+            }
+
+            riscv->branch = model;
+
+            // branch events are visible in mhpmcounter registers and
+            // misprediction penalties in mcycle
+            riscv->hpmModel   = True;
+            riscv->cycleModel = True;
+
+            addBranchCommand(riscv);
+        }
+    }
+}
+
+//
+// Report and free branch predictor model for a hart
+//
+void riscvFreeBranch(riscvP riscv) {
+
+    riscvBranchModelP model = riscv->branch;
+
+    if(model) {
+
+        riscvBranchSiteP site;
+        Uns32            i;
+
+        dumpBranch(riscv);
+
+        for(i=0; i<SITE_HASH_SIZE; i++) {
+            while((site=model->sites[i])) {
+                model->sites[i] = site->next;
+                STYPE_FREE(site);
+            }
+        }
+
+        for(i=0; i<TAGE_TABLES; i++) {
+            if(model->tage[i]) {
+                STYPE_FREE(model->tage[i]);
+            }
+        }
+
+        if(model->ras) {
+            STYPE_FREE(model->ras);
+        }
+
+        STYPE_FREE(model->counters);
+        STYPE_FREE(model->btb);
+        STYPE_FREE(model);
+
+        riscv->branch = 0;
+    }
+}
+
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2005-2023 Imperas Software Ltd., www.imperas.com
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+// VMI header files
+#include "vmi/vmiTypes.h"
+
+// model header files
+#include "riscvTypeRefs.h"
+
+
+//
+// Allocate branch predictor model and commands for a hart if required
+//
+void riscvNewBranch(riscvP riscv);
+
+//
+// Report and free branch predictor model for a hart
+//
+void riscvFreeBranch(riscvP riscv);
+
+//
+// Emit code to simulate prediction of a conditional branch to the given target
+// if branch prediction is enabled (taken is a register holding the branch
+// condition)
+//
+void riscvEmitBranchConditional(riscvP riscv, Uns64 tgt, vmiReg taken);
+
+//
+// Emit code to simulate prediction of an unconditional jump if branch
+// prediction is enabled. If ra is VMI_NOREG, the jump target is the constant
+// tgt; otherwise it is given by register ra of the given size. isIndirect
+// indicates a jump using a register target (jalr) and hint indicates a call or
+// return.
+//
+void riscvEmitBranchJump(
+    riscvP      riscv,
+    vmiReg      ra,
+    Uns32       bits,
+    Uns64       tgt,
+    Uns64       linkPC,
+    vmiJumpHint hint,
+    Bool        isIndirect
+);
+
@@ -43,8 +43,11 @@
 #include "riscvMessage.h"
 #include "riscvMode.h"
 #include "riscvMorph.h"
+#include "riscvProfile.h"
 #include "riscvRegisters.h"
 #include "riscvStructure.h"
+#include "riscvTiming.h"
+#include "riscvTrace.h"
 #include "riscvTrigger.h"
 #include "riscvVariant.h"
 #include "riscvUtils.h"
@@ -418,7 +421,7 @@ static vmiFPRC updateCurrentRMValid(riscvP riscv) {
         // enable rounding mode valid state check if required
         if(!riscv->rmCheckValid) {
             riscv->rmCheckValid = True;
-            vmirtFlushAllDicts(processor);
+            riscvFlushAllDicts(riscv, RVFC_RM_CHECK);
         }
 
         // update state to reflect invalid RM change
@@ -776,13 +779,11 @@ void riscvConsolidateFPFlags(riscvP riscv) {
 //
 static void updateEndian(riscvP riscv) {
 
-    vmiProcessorP processor = (vmiProcessorP)riscv;
-
     // if this is the first time endianness has been changed, flush all
     // dictionaries (endianness checking is required)
     if(!riscv->checkEndian) {
         riscv->checkEndian = True;
-        vmirtFlushAllDicts(processor);
+        riscvFlushAllDicts(riscv, RVFC_ENDIAN);
     }
 }
 
@@ -4341,6 +4342,9 @@ static Uns64 getCycles(riscvP riscv) {
 
     Uns64 result = vmirtGetICount((vmiProcessorP)riscv);
 
+    // include excess latency not yet added to the processor cycle count
+    result += riscvGetPendingCycles(riscv);
+
     // exclude the current instruction if this is a true access
     if(!riscv->artifactAccess) {
         result--;
@@ -4389,6 +4393,47 @@ Bool riscvInhibitInstret(riscvP riscv) {
     return RD_CSR_FIELDC(riscv, mcountinhibit, IR) || stopCount(riscv, False);
 }
 
+//
+// Return mask of inhibited performance monitor counters
+//
+static Uns32 getInhibitHPM(riscvP riscv) {
+
+    Uns32 inhibit = RD_CSRC(riscv, mcountinhibit);
+
+    if(stopCount(riscv, False)) {
+        inhibit = -1;
+    }
+
+    return inhibit & WM32_counteren_HPM;
+}
+
+//
+// Common routine to read performance monitor counter (counting the event
+// selected by the corresponding mhpmevent). Model events are counted
+// regardless of mcountinhibit, so while a counter is inhibited its base holds
+// its frozen value instead of the event count at which it was zero.
+//
+static Uns64 hpmCounterR(riscvP riscv, Uns32 index) {
+
+    if(getInhibitHPM(riscv) & (1<<index)) {
+        return riscv->hpmBase[index];
+    } else {
+        return riscv->hpmEvents[riscv->hpmEvent[index]] - riscv->hpmBase[index];
+    }
+}
+
+//
+// Common routine to write performance monitor counter
+//
+static void hpmCounterW(riscvP riscv, Uns32 index, Uns64 newValue) {
+
+    if(getInhibitHPM(riscv) & (1<<index)) {
+        riscv->hpmBase[index] = newValue;
+    } else {
+        riscv->hpmBase[index] = riscv->hpmEvents[riscv->hpmEvent[index]] - newValue;
+    }
+}
+
 //
 // Common routine to read cycle counter
 //
@@ -4665,10 +4710,18 @@ static RISCV_CSR_WRITEFN(htimedeltahW) {
 //
 void riscvPreInhibit(riscvP riscv, riscvCountStateP state) {
 
+    Uns32 i;
+
     state->inhibitCycle   = riscvInhibitCycle(riscv);
     state->inhibitInstret = riscvInhibitInstret(riscv);
+    state->inhibitHPM     = getInhibitHPM(riscv);
     state->cycle          = cycleR(riscv);
     state->instret        = instretR(riscv);
+
+    // performance monitor counter values (if implemented)
+    for(i=3; riscv->hpmModel && (i<32); i++) {
+        state->hpm[i] = hpmCounterR(riscv, i);
+    }
 }
 
 //
@@ -4697,6 +4750,19 @@ void riscvPostInhibit(riscvP riscv, riscvCountStateP state, Bool preIncrement) {
 
         instretW(riscv, state->instret, preIncrement && !state->inhibitInstret);
     }
+
+    // set performance monitor counters *after* mcountinhibit update
+    if(riscv->hpmModel) {
+
+        Uns32 changed = state->inhibitHPM ^ getInhibitHPM(riscv);
+        Uns32 i;
+
+        for(i=3; i<32; i++) {
+            if(changed & (1<<i)) {
+                hpmCounterW(riscv, i, state->hpm[i]);
+            }
+        }
+    }
 }
 
 //
@@ -4719,27 +4785,87 @@ static RISCV_CSR_WRITEFN(mcountinhibitW) {
 }
 
 //
-// Read unimplemented performance monitor register
+// Is the performance monitor register an event selector (mhpmevent)?
+//
+inline static Bool isHPMEvent(riscvCSRAttrsCP attrs) {
+    return (attrs->csrNum & 0xfe0) == 0x320;
+}
+
+//
+// Is the performance monitor register the high half of a counter?
+//
+inline static Bool isHPMHigh(riscvCSRAttrsCP attrs) {
+    return attrs->csrNum & 0x080;
+}
+
+//
+// Read performance monitor register (implemented only if model events are
+// enabled by a cache or branch prediction model)
 //
 static RISCV_CSR_READFN(mhpmR) {
 
-    if(riscvHPMAccessValid(attrs, riscv)) {
+    Uns64 result = 0;
+
+    if(!riscvHPMAccessValid(attrs, riscv)) {
+
         // no action
+
+    } else if(riscv->hpmModel) {
+
+        Uns32 index = attrs->csrNum & 31;
+
+        if(isHPMEvent(attrs)) {
+            result = riscv->hpmEvent[index];
+        } else if(isHPMHigh(attrs)) {
+            result = hpmCounterR(riscv, index) >> 32;
+        } else {
+            result = getXLENValue(attrs, riscv, hpmCounterR(riscv, index));
+        }
     }
 
-    return 0;
+    return result;
 }
 
 //
-// Write unimplemented performance monitor register
+// Write performance monitor register (implemented only if model events are
+// enabled by a cache or branch prediction model)
 //
 static RISCV_CSR_WRITEFN(mhpmW) {
 
-    if(riscvHPMAccessValid(attrs, riscv)) {
-        // no action
+    if(!riscvHPMAccessValid(attrs, riscv)) {
+
+        newValue = 0;
+
+    } else if(!riscv->hpmModel) {
+
+        newValue = 0;
+
+    } else {
+
+        Uns32 index    = attrs->csrNum & 31;
+        Uns64 oldValue = hpmCounterR(riscv, index);
+
+        if(isHPMEvent(attrs)) {
+
+            // unknown events are not counted, and the counter value is
+            // preserved when the event changes
+            if(newValue>=RVHE_LAST) {
+                newValue = RVHE_NONE;
+            }
+
+            riscv->hpmEvent[index] = newValue;
+            hpmCounterW(riscv, index, oldValue);
+
+        } else if(isHPMHigh(attrs)) {
+            hpmCounterW(riscv, index, setUpper(newValue, oldValue));
+        } else if(RISCV_XLEN_IS_32M(riscv, getCSRMode5(attrs, riscv))) {
+            hpmCounterW(riscv, index, setLower(newValue, oldValue));
+        } else {
+            hpmCounterW(riscv, index, newValue);
+        }
     }
 
-    return 0;
+    return newValue;
 }
 
 
@@ -5303,20 +5429,6 @@ inline static Uns32 getMaxVL(riscvP riscv) {
     return riscvGetMaxVL(riscv, getCurrentVType(riscv));
 }
 
-//
-// Return current vtype.vta
-//
-inline static Bool getVTA(riscvP riscv) {
-    return getVTypeVTA(getCurrentVType(riscv));
-}
-
-//
-// Return current vtype.vma
-//
-inline static Bool getVMA(riscvP riscv) {
-    return getVTypeVMA(getCurrentVType(riscv));
-}
-
 //
 // Write vxrm register
 //
@@ -5395,14 +5507,42 @@ static RISCV_CSR_WRITEFN(vcsrW) {
     return RD_CSRC(riscv, vcsr);
 }
 
+//
+// Return the vector part of the polymorphic block key for the given legal
+// vtype and vl class
+//
+Uns32 riscvGetVectorPMKey(
+    riscvP         riscv,
+    riscvVType     vtype,
+    riscvVLClassMt vlClass
+) {
+    Uns32 pmKey = vlClass;
+
+    // handle agnostic elements
+    if(riscv->configInfo.agnostic_ones) {
+
+        // handle tail agnostic setting
+        if(getVTypeVTA(vtype)) {
+            pmKey |= PMK_VECTOR_VTA1;
+        }
+
+        // handle mask agnostic setting
+        if(getVTypeVMA(vtype)) {
+            pmKey |= PMK_VECTOR_VMA1;
+        }
+    }
+
+    // include vtypeKey
+    return pmKey | (vtype.u.u32<<2);
+}
+
 //
 // Refresh the vector polymorphic block key
 //
 void riscvRefreshVectorPMKey(riscvP riscv) {
 
-    Uns32 vl       = RD_CSRC(riscv, vl);
-    Uns32 vtypeKey = RD_CSRC(riscv, vtype)<<2;
-    Uns32 villKey  = RD_CSR_FIELD_U(riscv, vtype, vill)<<2;
+    Uns32 vl      = RD_CSRC(riscv, vl);
+    Uns32 villKey = RD_CSR_FIELD_U(riscv, vtype, vill)<<2;
     Uns32 pmKey;
 
     if(villKey) {
@@ -5412,35 +5552,28 @@ void riscvRefreshVectorPMKey(riscvP riscv) {
 
     } else {
 
+        riscvVLClassMt vlClass;
+
         // handle legal settings
         if(!vl) {
-            pmKey = VLCLASSMT_ZERO;
+            vlClass = VLCLASSMT_ZERO;
         } else if(vl==getMaxVL(riscv)) {
-            pmKey = VLCLASSMT_MAX;
+            vlClass = VLCLASSMT_MAX;
         } else {
-            pmKey = VLCLASSMT_NONZERO;
+            vlClass = VLCLASSMT_NONZERO;
         }
 
-        // handle agnostic elements
-        if(riscv->configInfo.agnostic_ones) {
+        pmKey = riscvGetVectorPMKey(riscv, getCurrentVType(riscv), vlClass);
+    }
 
-            // handle tail agnostic setting
-            if(getVTA(riscv)) {
-                pmKey |= PMK_VECTOR_VTA1;
-            }
+    // get updated polymorphic key
+    Uns16 newKey = (riscv->pmKey & ~PMK_VECTOR) | pmKey;
 
-            // handle mask agnostic setting
-            if(getVMA(riscv)) {
-                pmKey |= PMK_VECTOR_VMA1;
-            }
-        }
-
-        // include vtypeKey
-        pmKey |= vtypeKey;
+    // update polymorphic key, recording any change
+    if(riscv->pmKey != newKey) {
+        riscvProfilePMKeyChange(riscv);
+        riscv->pmKey = newKey;
     }
-
-    // update polymorphic key
-    riscv->pmKey = (riscv->pmKey & ~PMK_VECTOR) | pmKey;
 }
 
 //
@@ -10581,6 +10714,7 @@ void riscvEmitCSRWrite(
     Uns32           csrBits = getCSREffectiveBits(attrs, riscv);
     Uns32           minBits = (rsBits<csrBits) ? rsBits : csrBits;
     riscvCSRWriteFn writeCB = getCSRWriteCB(attrs, riscv, csrBits);
+    riscvCSRReadFn  readCB  = getCSRReadCB(attrs, riscv, csrBits, False, True);
     vmiReg          raw     = getRawCurrent(attrs, riscv);
     Uns64           mask    = getCSRWriteMask(attrs, riscv);
     const char     *name    = getNameCurrent(attrs, riscv);
@@ -10636,6 +10770,15 @@ void riscvEmitCSRWrite(
         // extend value to CSR bits
         vmimtMoveExtendRR(csrBits, raw, minBits, raw, False);
     }
+
+    // record CSR value in commit log if required (the value is held in the
+    // processor structure unless the CSR has a read callback)
+    riscvEmitTraceCSRWrite(
+        riscv,
+        attrs,
+        readCB ? 0 : getCSRRegValue(attrs, riscv),
+        csrBits==64
+    );
 }
 
 
@@ -10873,6 +11016,18 @@ void riscvCSRSave(
             VMIRT_SAVE_FIELD(cxt, riscv, baseCycles);
             VMIRT_SAVE_FIELD(cxt, riscv, baseInstructions);
 
+            // approximate cycle state
+            if(riscv->cycleModel) {
+                VMIRT_SAVE_FIELD(cxt, riscv, pendingCycles);
+            }
+
+            // model performance monitor event state
+            if(riscv->hpmModel) {
+                VMIRT_SAVE_FIELD(cxt, riscv, hpmEvents);
+                VMIRT_SAVE_FIELD(cxt, riscv, hpmBase);
+                VMIRT_SAVE_FIELD(cxt, riscv, hpmEvent);
+            }
+
             // read-only vector register state requires explicit save
             if(vectorPresent(riscv)) {
                 VMIRT_SAVE_FIELD(cxt, riscv, csr.vl);
@@ -10930,6 +11085,18 @@ void riscvCSRRestore(
             VMIRT_RESTORE_FIELD(cxt, riscv, baseCycles);
             VMIRT_RESTORE_FIELD(cxt, riscv, baseInstructions);
 
+            // approximate cycle state
+            if(riscv->cycleModel) {
+                VMIRT_RESTORE_FIELD(cxt, riscv, pendingCycles);
+            }
+
+            // model performance monitor event state
+            if(riscv->hpmModel) {
+                VMIRT_RESTORE_FIELD(cxt, riscv, hpmEvents);
+                VMIRT_RESTORE_FIELD(cxt, riscv, hpmBase);
+                VMIRT_RESTORE_FIELD(cxt, riscv, hpmEvent);
+            }
+
             // read-only vector register state requires explicit restore
             if(vectorPresent(riscv)) {
                 VMIRT_RESTORE_FIELD(cxt, riscv, csr.vl);
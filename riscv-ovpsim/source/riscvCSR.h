@@ -24,6 +24,7 @@
 #include "vmi/vmiTypes.h"
 
 // model header files
+#include "riscvBlockState.h"
 #include "riscvFeatures.h"
 #include "riscvMode.h"
 #include "riscvRegisters.h"
@@ -555,8 +556,10 @@ Bool riscvHPMAccessValid(riscvCSRAttrsCP attrs, riscvP riscv);
 typedef struct riscvCountStateS {
     Bool  inhibitCycle;     // old value of cycle count inhibit
     Bool  inhibitInstret;   // old value of retired instruction inhibit
+    Uns32 inhibitHPM;       // old value of performance monitor inhibit mask
     Uns64 cycle;            // cycle count before update
     Uns64 instret;          // retired instruction count before update
+    Uns64 hpm[32];          // performance monitor counts before update
 } riscvCountState, *riscvCountStateP;
 
 //
@@ -624,6 +627,16 @@ void riscvCSRRestore(
 // POLYMORPHIC VECTOR BLOCK CONTROL
 ////////////////////////////////////////////////////////////////////////////////
 
+//
+// Return the vector part of the polymorphic block key for the given legal
+// vtype and vl class
+//
+Uns32 riscvGetVectorPMKey(
+    riscvP         riscv,
+    riscvVType     vtype,
+    riscvVLClassMt vlClass
+);
+
 //
 // Refresh the vector polymorphic block key
 //
@@ -0,0 +1,776 @@
+/*
+ * Copyright (c) 2005-2023 Imperas Software Ltd., www.imperas.com
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Standard header files
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Imperas header files
+#include "hostapi/impAlloc.h"
+
+// VMI header files
+#include "vmi/vmiCommand.h"
+#include "vmi/vmiMessage.h"
+#include "vmi/vmiMt.h"
+#include "vmi/vmiRt.h"
+
+// model header files
+#include "riscvBlockState.h"
+#include "riscvCache.h"
+#include "riscvMessage.h"
+#include "riscvStructure.h"
+#include "riscvTiming.h"
+#include "riscvUtils.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+// TYPES
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Name of cache statistics command
+//
+#define CACHE_STATS_NAME "cacheStatistics"
+
+//
+// Tag value indicating an invalid cache line
+//
+#define CACHE_INVALID ((Uns64)-1)
+
+//
+// Cache replacement policy
+//
+typedef enum riscvCachePolicyE {
+    RVCP_LRU,           // least-recently used
+    RVCP_FIFO,          // first-in, first-out
+    RVCP_RANDOM,        // pseudo-random
+    RVCP_LAST           // KEEP LAST: for sizing
+} riscvCachePolicy;
+
+//
+// Cache replacement policy names
+//
+static const char *policyNames[RVCP_LAST] = {
+    [RVCP_LRU]    = "lru",
+    [RVCP_FIFO]   = "fifo",
+    [RVCP_RANDOM] = "random",
+};
+
+//
+// This is one simulated cache
+//
+typedef struct riscvCacheS {
+    const char      *name;          // cache name (for reports)
+    Uns64           *tags;          // line tag for each way of each set
+    Uns64           *stamps;        // use (LRU) or fill (FIFO) time of each way
+    Uns64            clock;         // stamp source
+    Uns64            size;          // size in bytes
+    Uns32            ways;          // associativity
+    Uns32            lineBytes;     // line size in bytes
+    Uns32            lineShift;     // log2(lineBytes)
+    Uns32            setMask;       // number of sets - 1
+    Uns32            missCycles;    // miss penalty in cycles
+    Uns32            lfsr;          // random replacement state
+    riscvCachePolicy policy;        // replacement policy
+    riscvHPMEvent    accessEvent;   // event counting accesses
+    riscvHPMEvent    missEvent;     // event counting misses
+    Uns64            accesses;      // line accesses simulated
+    Uns64            misses;        // line misses simulated
+    Uns64            writes;        // line writes simulated
+    Uns64            writeMisses;   // line write misses simulated
+} riscvCache;
+
+//
+// This holds cache models for a hart
+//
+typedef struct riscvCacheModelS {
+    riscvCacheP I;                  // instruction cache (if any)
+    riscvCacheP D;                  // data cache (if any)
+    Uns32       sample;             // one in sample blocks simulated
+    Uns32       countdown;          // blocks until next sampled block
+    Uns8        active;             // whether current block is sampled
+} riscvCacheModel;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// CONFIGURATION
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Return log2 of value if it is a non-zero power of two, or -1 otherwise
+//
+static Int32 getLog2(Uns64 value) {
+    return (value && !(value & (value-1))) ? __builtin_ctzll(value) : -1;
+}
+
+//
+// Return the replacement policy with the given name (of the given length), or
+// RVCP_LAST if there is none
+//
+static riscvCachePolicy findPolicy(const char *name, Uns32 length) {
+
+    riscvCachePolicy policy;
+
+    for(policy=0; policy<RVCP_LAST; policy++) {
+        if((strlen(policyNames[policy])==length) && !strncmp(policyNames[policy], name, length)) {
+            break;
+        }
+    }
+
+    return policy;
+}
+
+//
+// Parse a cache specification of the form "key=value,key=value,..." with keys
+// size (bytes, optionally suffixed with K or M), ways, line (bytes), policy
+// (lru, fifo or random) and miss (penalty cycles), returning False if it is
+// malformed
+//
+static Bool parseCache(riscvCacheP cache, const char *spec) {
+
+    const char *s = spec;
+
+    while(*s) {
+
+        const char *eq    = strchr(s, '=');
+        const char *value = eq ? eq+1 : 0;
+        const char *end   = value ? strchr(value, ',') : 0;
+        Uns32       keyLength;
+        Uns32       valueLength;
+        char       *numEnd;
+        Uns64       num;
+
+        if(!eq) {
+            return False;
+        }
+
+        if(!end) {
+            end = value+strlen(value);
+        }
+
+        keyLength   = eq-s;
+        valueLength = end-value;
+
+        if((keyLength==6) && !strncmp(s, "policy", 6)) {
+
+            if((cache->policy=findPolicy(value, valueLength))==RVCP_LAST) {
+                return False;
+            }
+
+        } else {
+
+            num = strtoull(value, &numEnd, 0);
+
+            // allow K and M suffixes
+            if((*numEnd=='K') || (*numEnd=='k')) {
+                num <<= 10; numEnd++;
+            } else if((*numEnd=='M') || (*numEnd=='m')) {
+                num <<= 20; numEnd++;
+            }
+
+            if((numEnd==value) || (numEnd!=end)) {
+                return False;
+            } else if((keyLength==4) && !strncmp(s, "size", 4)) {
+                cache->size = num;
+            } else if((keyLength==4) && !strncmp(s, "ways", 4)) {
+                cache->ways = num;
+            } else if((keyLength==4) && !strncmp(s, "line", 4)) {
+                cache->lineBytes = num;
+            } else if((keyLength==4) && !strncmp(s, "miss", 4)) {
+                cache->missCycles = num;
+            } else {
+                return False;
+            }
+        }
+
+        s = *end ? end+1 : end;
+    }
+
+    return True;
+}
+
+//
+// Allocate a cache model from the given specification, or return NULL if none
+// is specified or the specification is invalid
+//
+static riscvCacheP newCache(
+    const char   *name,
+    const char   *param,
+    const char   *spec,
+    riscvHPMEvent accessEvent,
+    riscvHPMEvent missEvent
+) {
+    riscvCacheP cache = 0;
+
+    if(spec && spec[0]) {
+
+        Int32 lineShift;
+        Int32 setShift;
+
+        cache = STYPE_CALLOC(riscvCache);
+
+        // default configuration
+        cache->name        = name;
+        cache->size        = 32*1024;
+        cache->ways        = 4;
+        cache->lineBytes   = 64;
+        cache->policy      = RVCP_LRU;
+        cache->lfsr        = 0xace1;
+        cache->accessEvent = accessEvent;
+        cache->missEvent   = missEvent;
+
+        if(
+            !parseCache(cache, spec) ||
+            !cache->ways ||
+            ((lineShift=getLog2(cache->lineBytes))<2) ||
+            ((setShift=getLog2(cache->size/cache->ways/cache->lineBytes))<0) ||
+            (cache->size != ((Uns64)cache->ways*cache->lineBytes)<<setShift)
+        ) {
+            vmiMessage("W", CPU_PREFIX"_ICS",
+                "Invalid %s specification '%s' - expected comma-separated "
+                "key=value with key one of size, ways, line, policy (lru, "
+                "fifo or random) or miss; line size and number of sets must "
+                "be powers of two (ignored)",
+                param, spec
+            );
+
+            STYPE_FREE(cache);
+            cache = 0;
+
+        } else {
+
+            Uns32 entries = cache->ways<<setShift;
+            Uns32 i;
+
+            cache->lineShift = lineShift;
+            cache->setMask   = (1<<setShift)-1;
+            cache->tags      = STYPE_CALLOC_N(Uns64, entries);
+            cache->stamps    = STYPE_CALLOC_N(Uns64, entries);
+
+            for(i=0; i<entries; i++) {
+                cache->tags[i] = CACHE_INVALID;
+            }
+        }
+    }
+
+    return cache;
+}
+
+//
+// Free a cache model
+//
+static void freeCache(riscvCacheP cache) {
+
+    if(cache) {
+        STYPE_FREE(cache->tags);
+        STYPE_FREE(cache->stamps);
+        STYPE_FREE(cache);
+    }
+}
+
+//
+// Invalidate all lines and clear statistics for a cache model
+//
+static void resetCache(riscvCacheP cache) {
+
+    if(cache) {
+
+        Uns32 entries = cache->ways*(cache->setMask+1);
+        Uns32 i;
+
+        for(i=0; i<entries; i++) {
+            cache->tags[i]   = CACHE_INVALID;
+            cache->stamps[i] = 0;
+        }
+
+        cache->clock       = 0;
+        cache->accesses    = 0;
+        cache->misses      = 0;
+        cache->writes      = 0;
+        cache->writeMisses = 0;
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// SIMULATION
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Select the way to replace in a set with no matching line
+//
+static Uns32 selectVictim(riscvCacheP cache, Uns64 *tags, Uns64 *stamps) {
+
+    Uns32 ways   = cache->ways;
+    Uns32 victim = 0;
+    Uns32 i;
+
+    // use an invalid way if there is one
+    for(i=0; i<ways; i++) {
+        if(tags[i]==CACHE_INVALID) {
+            return i;
+        }
+    }
+
+    if(cache->policy==RVCP_RANDOM) {
+
+        // 16-bit Fibonacci LFSR
+        Uns32 lfsr = cache->lfsr;
+        Uns32 bit  = ((lfsr>>0) ^ (lfsr>>2) ^ (lfsr>>3) ^ (lfsr>>5)) & 1;
+
+        cache->lfsr = (lfsr>>1) | (bit<<15);
+        victim      = cache->lfsr % ways;
+
+    } else {
+
+        // LRU and FIFO both replace the oldest stamp (LRU stamps are updated
+        // on every hit, FIFO stamps only when filled)
+        for(i=1; i<ways; i++) {
+            if(stamps[i]<stamps[victim]) {
+                victim = i;
+            }
+        }
+    }
+
+    return victim;
+}
+
+//
+// Look up a line in the cache, filling it on a miss; return True on a hit
+//
+static Bool lookupLine(riscvCacheP cache, Uns64 line) {
+
+    Uns32  base   = (line & cache->setMask) * cache->ways;
+    Uns64 *tags   = &cache->tags[base];
+    Uns64 *stamps = &cache->stamps[base];
+    Uns32  ways   = cache->ways;
+    Uns32  i;
+
+    for(i=0; i<ways; i++) {
+
+        if(tags[i]==line) {
+
+            if(cache->policy==RVCP_LRU) {
+                stamps[i] = ++cache->clock;
+            }
+
+            return True;
+        }
+    }
+
+    // miss: allocate on both read and write
+    i = selectVictim(cache, tags, stamps);
+
+    tags[i]   = line;
+    stamps[i] = ++cache->clock;
+
+    return False;
+}
+
+//
+// Simulate an access of the given size, which may span more than one line
+//
+static void cacheAccess(
+    riscvP      riscv,
+    riscvCacheP cache,
+    Uns64       address,
+    Uns32       bytes,
+    Bool        isStore
+) {
+    Uns32 weight = riscv->cache->sample;
+    Uns64 first  = address>>cache->lineShift;
+    Uns64 last   = (address+bytes-1)>>cache->lineShift;
+    Uns64 line;
+
+    for(line=first; line<=last; line++) {
+
+        Bool hit = lookupLine(cache, line);
+
+        cache->accesses++;
+        cache->writes += isStore;
+
+        // event counts and miss penalty are scaled by the sampling interval to
+        // estimate totals
+        riscv->hpmEvents[cache->accessEvent] += weight;
+
+        if(!hit) {
+
+            cache->misses++;
+            cache->writeMisses += isStore;
+
+            riscv->hpmEvents[cache->missEvent] += weight;
+
+            if(cache->missCycles) {
+                riscvAddPendingCycles(riscv, (Uns64)cache->missCycles*weight);
+            }
+        }
+    }
+}
+
+//
+// Simulate instruction fetch
+//
+static void fetchCB(riscvP riscv, Uns64 address, Uns32 bytes) {
+    cacheAccess(riscv, riscv->cache->I, address, bytes, False);
+}
+
+//
+// Simulate data load or store
+//
+static void accessCB(
+    riscvP riscv,
+    Uns64  base,
+    Uns64  offset,
+    Uns32  bytes,
+    Bool   isStore,
+    Bool   is32
+) {
+    Uns64 address = base+offset;
+
+    if(is32) {
+        address = (Uns32)address;
+    }
+
+    cacheAccess(riscv, riscv->cache->D, address, bytes, isStore);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// CODE GENERATION
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Return vmiReg for a field in the cache model structure
+//
+#define CACHE_MODEL_REG(_RISCV, _F) \
+    vmimtGetExtReg((vmiProcessorP)(_RISCV), &(_RISCV)->cache->_F)
+
+//
+// Emit code at the start of a block to select whether it is sampled: one in
+// every sample blocks executed is simulated
+//
+static void emitSampleBlock(riscvP riscv) {
+
+    riscvCacheModelP model     = riscv->cache;
+    vmiReg           countdown = CACHE_MODEL_REG(riscv, countdown);
+    vmiReg           active    = CACHE_MODEL_REG(riscv, active);
+    vmiLabelP        done      = vmimtNewLabel();
+
+    vmimtMoveRC(8, active, 0);
+    vmimtBinopRC(32, vmi_SUB, countdown, 1, 0);
+    vmimtCompareRCJumpLabel(32, vmi_COND_NE, countdown, 0, done);
+    vmimtMoveRC(32, countdown, model->sample);
+    vmimtMoveRC(8, active, 1);
+    vmimtInsertLabel(done);
+}
+
+//
+// If sampling is enabled, emit code to skip a following cache model call if
+// the current block is not sampled, returning the label to insert after it
+//
+static vmiLabelP emitSampleSkip(riscvP riscv) {
+
+    vmiLabelP skip = 0;
+
+    if(riscv->cache->sample>1) {
+        skip = vmimtNewLabel();
+        vmimtCompareRCJumpLabel(8, vmi_COND_EQ, CACHE_MODEL_REG(riscv, active), 0, skip);
+    }
+
+    return skip;
+}
+
+//
+// Insert label returned by emitSampleSkip
+//
+static void emitSampleSkipEnd(vmiLabelP skip) {
+
+    if(skip) {
+        vmimtInsertLabel(skip);
+    }
+}
+
+//
+// Emit code to simulate instruction cache access for an instruction of the
+// given size at the given address if instruction cache simulation is enabled.
+// Because a block is sequential, only the first instruction in each line of a
+// block generates a call.
+//
+void riscvEmitCacheFetch(riscvP riscv, Uns64 thisPC, Uns32 bytes) {
+
+    riscvCacheModelP model = riscv->cache;
+
+    if(model) {
+
+        riscvBlockStateP blockState = riscv->blockState;
+
+        // select whether block is sampled with the first instruction
+        if(blockState->sampleBlock) {
+
+            blockState->sampleBlock = False;
+
+            if(model->sample>1) {
+                emitSampleBlock(riscv);
+            }
+        }
+
+        if(model->I) {
+
+            Uns32 shift = model->I->lineShift;
+            Uns64 first = thisPC>>shift;
+            Uns64 last  = (thisPC+bytes-1)>>shift;
+
+            if(last!=blockState->fetchLine) {
+
+                // skip any part of the instruction in the previous line
+                Uns64     address = (first==blockState->fetchLine) ? last<<shift : thisPC;
+                vmiLabelP skip;
+
+                // transfer pending cycles if misses add cycles
+                if(model->I->missCycles) {
+                    riscvEmitTimingFlush(riscv);
+                }
+
+                skip = emitSampleSkip(riscv);
+
+                vmimtArgProcessor();
+                vmimtArgUns64(address);
+                vmimtArgUns32(thisPC+bytes-address);
+                vmimtCall((vmiCallFn)fetchCB);
+
+                emitSampleSkipEnd(skip);
+
+                blockState->fetchLine = last;
+            }
+        }
+    }
+}
+
+//
+// Emit code to simulate data cache access for a load or store with address
+// ra+offset if data cache simulation is enabled
+//
+void riscvEmitCacheAccess(
+    riscvP riscv,
+    vmiReg ra,
+    Uns64  offset,
+    Uns32  memBits,
+    Bool   isStore
+) {
+    riscvCacheModelP model = riscv->cache;
+
+    if(model && model->D) {
+
+        Uns32     raBits = riscvGetXlenMode(riscv);
+        vmiLabelP skip;
+
+        // transfer pending cycles if misses add cycles
+        if(model->D->missCycles) {
+            riscvEmitTimingFlush(riscv);
+        }
+
+        skip = emitSampleSkip(riscv);
+
+        vmimtArgProcessor();
+
+        if(VMI_ISNOREG(ra)) {
+            vmimtArgUns64(0);
+        } else {
+            vmimtArgRegSimAddress(raBits, ra);
+        }
+
+        vmimtArgUns64(offset);
+        vmimtArgUns32(memBits/8);
+        vmimtArgUns32(isStore);
+        vmimtArgUns32(raBits==32);
+        vmimtCall((vmiCallFn)accessCB);
+
+        emitSampleSkipEnd(skip);
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// REPORTING
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Print one statistic
+//
+static void printStat(const char *name, Uns64 count) {
+
+    char countString[32];
+
+    sprintf(countString, FMT_Au, count);
+
+    vmiPrintf("    %-20s %16s\n", name, countString);
+}
+
+//
+// Print statistics for one cache
+//
+static void dumpCache(riscvCacheP cache) {
+
+    if(cache) {
+
+        Uns64  hits = cache->accesses-cache->misses;
+        double rate = cache->accesses ? 100.0*cache->misses/cache->accesses : 0;
+
+        vmiPrintf(
+            "  %s: "FMT_Au" bytes, %u-way, %u-byte lines, %s, %u miss cycles\n",
+            cache->name, cache->size, cache->ways, cache->lineBytes,
+            policyNames[cache->policy], cache->missCycles
+        );
+        printStat("accesses", cache->accesses);
+        printStat("hits", hits);
+        printStat("misses", cache->misses);
+        printStat("writes", cache->writes);
+        printStat("write misses", cache->writeMisses);
+        vmiPrintf("    %-20s %15.2f%%\n", "miss rate", rate);
+    }
+}
+
+//
+// Print cache statistics for a hart
+//
+static void dumpCaches(riscvP riscv) {
+
+    riscvCacheModelP model = riscv->cache;
+
+    vmiPrintf(
+        "Cache statistics for '%s' (one in %u blocks sampled):\n",
+        vmirtProcessorName((vmiProcessorP)riscv), model->sample
+    );
+
+    dumpCache(model->I);
+    dumpCache(model->D);
+}
+
+//
+// Handle dump or reset of cache statistics
+//
+static VMIRT_COMMAND_PARSE_FN(cacheStatistics) {
+
+    riscvP       riscv    = (riscvP)processor;
+    vmiArgValueP argDump  = vmirtFindArgValue(argc, argv, "dump");
+    vmiArgValueP argReset = vmirtFindArgValue(argc, argv, "reset");
+    Bool         found    = False;
+
+    // handle "dump" argument
+    if(argDump && argDump->isSet) {
+        dumpCaches(riscv);
+        found = True;
+    }
+
+    // handle "reset" argument
+    if(argReset && argReset->isSet) {
+        resetCache(riscv->cache->I);
+        resetCache(riscv->cache->D);
+        found = True;
+    }
+
+    if(!found) {
+
+        vmiPrintf("%s: -dump -reset\n", CACHE_STATS_NAME);
+
+        // error status
+        return NULL;
+    }
+
+    return "1";
+}
+
+//
+// Add command for cache statistics dump and reset
+//
+static void addCacheCommand(riscvP riscv) {
+
+    vmiCommandP cmd = vmirtAddCommandParse(
+        (vmiProcessorP)riscv,
+        CACHE_STATS_NAME,
+        "show or reset cache statistics (resetting also invalidates caches)",
+        cacheStatistics,
+        VMI_CT_DEFAULT|VMI_CO_DIAG|VMI_CA_REPORT
+    );
+
+    const char *dumpHelp  = "print cache hit and miss statistics";
+    const char *resetHelp = "invalidate caches and clear statistics";
+
+    vmirtAddArg(cmd, "dump",  dumpHelp,  VMI_CA_BOOL, VMI_CAA_DEFAULT, False, 0);
+    vmirtAddArg(cmd, "reset", resetHelp, VMI_CA_BOOL, VMI_CAA_DEFAULT, False, 0);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// INTERFACE ROUTINES
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Allocate cache models and commands for a hart if required
+//
+void riscvNewCache(riscvP riscv) {
+
+    riscvCacheP I = newCache(
+        "I-cache", "icache", riscv->icacheSpec,
+        RVHE_ICACHE_ACCESS, RVHE_ICACHE_MISS
+    );
+    riscvCacheP D = newCache(
+        "D-cache", "dcache", riscv->dcacheSpec,
+        RVHE_DCACHE_ACCESS, RVHE_DCACHE_MISS
+    );
+
+    if(I || D) {
+
+        riscvCacheModelP model = riscv->cache = STYPE_CALLOC(riscvCacheModel);
+
+        model->I         = I;
+        model->D         = D;
+        model->sample    = riscv->cacheSample;
+        model->countdown = 1;
+        model->active    = True;
+
+        // cache events are visible in mhpmcounter registers and miss
+        // penalties in mcycle
+        riscv->hpmModel   = True;
+        riscv->cycleModel = True;
+
+        addCacheCommand(riscv);
+    }
+}
+
+//
+// Report and free cache models for a hart
+//
+void riscvFreeCache(riscvP riscv) {
+
+    riscvCacheModelP model = riscv->cache;
+
+    if(model) {
+
+        dumpCaches(riscv);
+
+        freeCache(model->I);
+        freeCache(model->D);
+
+        STYPE_FREE(model);
+        riscv->cache = 0;
+    }
+}
+
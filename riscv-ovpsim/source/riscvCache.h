@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2005-2023 Imperas Software Ltd., www.imperas.com
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+// VMI header files
+#include "vmi/vmiTypes.h"
+
+// model header files
+#include "riscvTypeRefs.h"
+
+
+//
+// Allocate cache models and commands for a hart if required
+//
+void riscvNewCache(riscvP riscv);
+
+//
+// Report and free cache models for a hart
+//
+void riscvFreeCache(riscvP riscv);
+
+//
+// Emit code to simulate instruction cache access for an instruction of the
+// given size at the given address if instruction cache simulation is enabled
+//
+void riscvEmitCacheFetch(riscvP riscv, Uns64 thisPC, Uns32 bytes);
+
+//
+// Emit code to simulate data cache access for a load or store with address
+// ra+offset if data cache simulation is enabled
+//
+void riscvEmitCacheAccess(
+    riscvP riscv,
+    vmiReg ra,
+    Uns64  offset,
+    Uns32  memBits,
+    Bool   isStore
+);
+
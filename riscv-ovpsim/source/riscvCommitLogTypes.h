@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2005-2023 Imperas Software Ltd., www.imperas.com
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+//
+// This file describes the layout of the shared-memory commit log published by
+// each hart when parameter commit_log is specified. It uses only fixed-size
+// types so that it can be included by a consumer (for example, a co-simulating
+// testbench) that does not use the model headers.
+//
+#include <stdint.h>
+
+//
+// Commit log identification
+//
+#define RVCL_MAGIC   "RVCOMMIT"
+#define RVCL_VERSION 2
+
+//
+// Number of record slots in the ring (a power of two)
+//
+#define RVCL_SLOTS 4096
+
+//
+// Commit record flags
+//
+typedef enum riscvCommitFlagE {
+    RVCL_TRAP    = 0x01,    // instruction took a synchronous exception
+    RVCL_INTR    = 0x02,    // first instruction of an interrupt handler
+    RVCL_RD      = 0x04,    // rdAddr/rdData are valid
+    RVCL_FD      = 0x08,    // fdAddr/fdData are valid
+    RVCL_CSR     = 0x10,    // csrAddr/csrData are valid
+    RVCL_LOAD    = 0x20,    // memAddr/memBytes give a load
+    RVCL_STORE   = 0x40,    // memAddr/memBytes give a store
+    RVCL_VD      = 0x80,    // vMask/vdAddr/vdData are valid
+} riscvCommitFlag;
+
+//
+// This is one retired instruction (modeled on the RISC-V Formal Interface).
+// Registers written by instructions that write more than one X register are
+// indicated in xMask; only the lowest-numbered is given in rdAddr/rdData.
+// Only the first load or store by the instruction is given in memAddr/memBytes
+// (an atomic read-modify-write sets both RVCL_LOAD and RVCL_STORE). Vector
+// registers written are indicated in vMask; because a vector register group
+// can hold up to 8KB, only the low 64 bits of the lowest-numbered register
+// (fewer if VLEN is 32) are given in vdData, so a consumer must compare
+// complete vector results by other means.
+//
+typedef struct riscvCommitRecordS {
+    uint64_t order;         // retirement index
+    uint64_t pc;            // instruction address
+    uint64_t nextPC;        // address of next instruction executed
+    uint64_t insn;          // instruction pattern
+    uint64_t rdData;        // X register result
+    uint64_t fdData;        // F register result
+    uint64_t csrData;       // CSR value after write
+    uint64_t memAddr;       // virtual address of load or store
+    uint64_t vdData;        // low 64 bits of V register result
+    uint32_t xMask;         // mask of X registers written
+    uint32_t vMask;         // mask of V registers written
+    uint32_t cause;         // exception code (RVCL_TRAP or RVCL_INTR)
+    uint16_t csrAddr;       // CSR written
+    uint8_t  rdAddr;        // X register written
+    uint8_t  fdAddr;        // F register written
+    uint8_t  flags;         // riscvCommitFlag values
+    uint8_t  mode;          // privilege mode (riscvMode encoding)
+    uint8_t  bytes;         // instruction size in bytes
+    uint8_t  memBytes;      // size of load or store in bytes
+    uint8_t  vdAddr;        // lowest V register written
+    uint8_t  _pad[3];
+} riscvCommitRecord;
+
+//
+// This is the shared-memory ring. The model is the single producer and
+// advances head after each record is complete; the single consumer advances
+// tail after each record is read. Both indices increase monotonically and are
+// reduced modulo RVCL_SLOTS to give the slot index. A consumer sets attached
+// to a nonzero value while it is reading the ring and clears it when it
+// detaches. While the ring is full and a consumer is attached, the model waits
+// for the consumer to free a slot, so no record is lost and a consumer running
+// in lockstep throttles the model. While no consumer is attached, a record
+// that does not fit is discarded and dropped is incremented (the consumer can
+// detect the gap using the record order field).
+//
+typedef struct riscvCommitRingS {
+    char              magic[8];     // RVCL_MAGIC (set last by the producer)
+    uint32_t          version;      // RVCL_VERSION
+    uint32_t          slots;        // RVCL_SLOTS
+    uint32_t          recordBytes;  // sizeof(riscvCommitRecord)
+    uint32_t          xlen;         // architectural XLEN
+    uint8_t           _pad0[40];
+    volatile uint64_t head;         // records published (written by producer)
+    volatile uint64_t dropped;      // records discarded (written by producer)
+    uint8_t           _pad1[48];
+    volatile uint64_t tail;         // records consumed (written by consumer)
+    volatile uint32_t attached;     // consumer attached (written by consumer)
+    uint8_t           _pad2[52];
+    riscvCommitRecord records[RVCL_SLOTS];
+} riscvCommitRing;
+
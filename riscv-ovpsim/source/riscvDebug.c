@@ -44,6 +44,7 @@
 #include "riscvExceptions.h"
 #include "riscvFunctions.h"
 #include "riscvMessage.h"
+#include "riscvMorph.h"
 #include "riscvRegisters.h"
 #include "riscvStructure.h"
 #include "riscvUtils.h"
@@ -676,6 +677,52 @@ static VMI_REG_WRITE_FN(writePC) {
     return True;
 }
 
+//
+// Return the indexed vector register and its size in bytes
+//
+static Uns32 *getVRegValue(riscvP riscv, vmiRegInfoCP reg, Uns32 *bytesP) {
+
+    Uns32 VLEN  = riscv->configInfo.VLEN;
+    Uns32 index = (UnsPS)reg->userData;
+
+    *bytesP = VLEN/8;
+
+    return &riscv->v[index*VLEN/32];
+}
+
+//
+// Read vector register (shared zero registers are read if vector registers
+// have not yet been allocated)
+//
+static VMI_REG_READ_FN(readVR) {
+
+    riscvP riscv = (riscvP)processor;
+    Uns32  bytes;
+    Uns32 *value = getVRegValue(riscv, reg, &bytes);
+
+    memcpy(buffer, value, bytes);
+
+    return True;
+}
+
+//
+// Write vector register (vector registers are allocated unless the written
+// value leaves them zero)
+//
+static VMI_REG_WRITE_FN(writeVR) {
+
+    riscvP riscv = (riscvP)processor;
+    Uns32  bytes;
+    Uns32 *value = getVRegValue(riscv, reg, &bytes);
+
+    if(memcmp(value, buffer, bytes)) {
+        riscvAllocVector(riscv);
+        memcpy(getVRegValue(riscv, reg, &bytes), buffer, bytes);
+    }
+
+    return True;
+}
+
 //
 // Return CSR register attributes
 //
@@ -897,7 +944,9 @@ static vmiRegInfoCP getRegisters(riscvP riscv, Bool normal) {
             dst->bits     = riscv->configInfo.VLEN;
             dst->gdbIndex = i+RISCV_V0_INDEX;
             dst->access   = vmi_RA_RW;
-            dst->raw      = riscvGetVReg(riscv, i);
+            dst->readCB   = readVR;
+            dst->writeCB  = writeVR;
+            dst->userData = (void *)(UnsPS)i;
             dst++;
         }
 
@@ -44,17 +44,104 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 //
-// Fetch two bytes from the given address
+// Invalidate the instruction fetch buffer
+//
+void riscvInvalidateFetchBuffer(riscvP riscv) {
+    riscv->fetchBuffer.valid = 0;
+}
+
+//
+// Return a pointer to the fetch buffer entry for the given number of bytes
+// fetched from the given address, and set the mask of halfwords they occupy,
+// or return NULL if they cannot be buffered (the buffer is used only while a
+// code block is being translated)
+//
+static Uns16 *getFetchBuffer(
+    riscvP    riscv,
+    riscvAddr thisPC,
+    Uns32     bytes,
+    Uns32    *maskP
+) {
+    riscvFetchBufferP fb     = &riscv->fetchBuffer;
+    Uns64             base   = thisPC & -FETCH_BUFFER_BYTES;
+    Uns32             offset = thisPC & (FETCH_BUFFER_BYTES-1);
+
+    if(!riscv->blockState || ((offset+bytes)>FETCH_BUFFER_BYTES)) {
+
+        // not translating a block, or fetch spans chunks
+        return 0;
+
+    } else {
+
+        // start a new chunk if required
+        if(fb->base!=base) {
+            fb->base  = base;
+            fb->valid = 0;
+        }
+
+        *maskP = ((1<<(bytes/2))-1) << (offset/2);
+
+        return &fb->half[offset/2];
+    }
+}
+
+//
+// Fetch two bytes from the given address, using the value from any previous
+// fetch of the same address while the block is being translated
 //
 inline static Uns16 fetch2(riscvP riscv, riscvAddr thisPC) {
-    return vmicxtFetch2Byte((vmiProcessorP)riscv, thisPC);
+
+    Uns32 *valid = &riscv->fetchBuffer.valid;
+    Uns32  mask;
+    Uns16 *half  = getFetchBuffer(riscv, thisPC, 2, &mask);
+    Uns16  result;
+
+    if(half && ((*valid&mask)==mask)) {
+
+        // repeated fetch of buffered halfword
+        result = half[0];
+
+    } else {
+
+        result = vmicxtFetch2Byte((vmiProcessorP)riscv, thisPC);
+
+        if(half) {
+            half[0] = result;
+            *valid |= mask;
+        }
+    }
+
+    return result;
 }
 
 //
-// Fetch four bytes from the given address
+// Fetch four bytes from the given address, using the value from any previous
+// fetch of the same address while the block is being translated
 //
 inline static Uns32 fetch4(riscvP riscv, riscvAddr thisPC) {
-    return vmicxtFetch4Byte((vmiProcessorP)riscv, thisPC);
+
+    Uns32 *valid = &riscv->fetchBuffer.valid;
+    Uns32  mask;
+    Uns16 *half  = getFetchBuffer(riscv, thisPC, 4, &mask);
+    Uns32  result;
+
+    if(half && ((*valid&mask)==mask)) {
+
+        // repeated fetch of buffered halfwords
+        result = half[0] | ((Uns32)half[1]<<16);
+
+    } else {
+
+        result = vmicxtFetch4Byte((vmiProcessorP)riscv, thisPC);
+
+        if(half) {
+            half[0] = result;
+            half[1] = result>>16;
+            *valid |= mask;
+        }
+    }
+
+    return result;
 }
 
 //
@@ -8223,15 +8310,9 @@ static void decode16(riscvP riscv, riscvInstrInfoP info) {
 }
 
 //
-// Decode instruction at the given address
+// Decode instruction with fetched pattern and size
 //
-void riscvDecode(
-    riscvP          riscv,
-    riscvAddr       thisPC,
-    riscvInstrInfoP info
-) {
-    info->thisPC      = thisPC;
-    info->instruction = riscvFetchInstruction(riscv, info->thisPC, &info->bytes);
+static void decodeFetched(riscvP riscv, riscvInstrInfoP info) {
 
     // decode based on instruction size
     if(info->bytes==2) {
@@ -8246,6 +8327,38 @@ void riscvDecode(
     fixPseudoInstructions(riscv, info);
 }
 
+//
+// Decode instruction at the given address
+//
+void riscvDecode(
+    riscvP          riscv,
+    riscvAddr       thisPC,
+    riscvInstrInfoP info
+) {
+    info->thisPC      = thisPC;
+    info->instruction = riscvFetchInstruction(riscv, info->thisPC, &info->bytes);
+
+    decodeFetched(riscv, info);
+}
+
+//
+// Decode the given instruction pattern as if fetched from the given address
+// (used to decode instructions recorded in a trace file)
+//
+void riscvDecodeInstruction(
+    riscvP          riscv,
+    riscvAddr       thisPC,
+    Uns64           instruction,
+    Uns8            bytes,
+    riscvInstrInfoP info
+) {
+    info->thisPC      = thisPC;
+    info->instruction = instruction;
+    info->bytes       = bytes;
+
+    decodeFetched(riscv, info);
+}
+
 //
 // Fetch instruction at address thisPC
 //
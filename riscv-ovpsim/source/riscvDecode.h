@@ -28,6 +28,11 @@
 #include "riscvTypeRefs.h"
 
 
+//
+// Invalidate the instruction fetch buffer
+//
+void riscvInvalidateFetchBuffer(riscvP riscv);
+
 //
 // Return instruction at address thisPC
 //
@@ -47,6 +52,17 @@ void riscvDecode(
     riscvInstrInfoP info
 );
 
+//
+// Decode the given instruction pattern as if fetched from the given address
+//
+void riscvDecodeInstruction(
+    riscvP          riscv,
+    riscvAddr       thisPC,
+    Uns64           instruction,
+    Uns8            bytes,
+    riscvInstrInfoP info
+);
+
 //
 // Fetch an instruction at the given simulated address and if it matches a
 // decode pattern in the given instruction table unpack the instruction fields
@@ -1097,6 +1097,26 @@ VMI_DISASSEMBLE_FN(riscvDisassemble) {
     return disassembleInfo(riscv, &info, attrs);
 }
 
+//
+// Disassemble the given instruction pattern as if fetched from the given
+// address
+//
+const char *riscvDisassembleEncoding(
+    riscvP         riscv,
+    riscvAddr      thisPC,
+    Uns64          instruction,
+    Uns8           bytes,
+    vmiDisassAttrs attrs
+) {
+    riscvInstrInfo info;
+
+    // decode instruction
+    riscvDecodeInstruction(riscv, thisPC, instruction, bytes, &info);
+
+    // return disassembled instruction
+    return disassembleInfo(riscv, &info, attrs);
+}
+
 //
 // Disassemble unpacked instruction using the given format
 //
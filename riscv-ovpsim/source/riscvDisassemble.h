@@ -23,6 +23,7 @@
 #include "vmi/vmiTypes.h"
 
 // model header files
+#include "riscvTypes.h"
 #include "riscvTypeRefs.h"
 
 
@@ -34,3 +35,15 @@ const char *riscvDisassembleInstruction(
     riscvExtInstrInfoP instrInfo,
     vmiDisassAttrs     attrs
 );
+
+//
+// Disassemble the given instruction pattern as if fetched from the given
+// address
+//
+const char *riscvDisassembleEncoding(
+    riscvP         riscv,
+    riscvAddr      thisPC,
+    Uns64          instruction,
+    Uns8           bytes,
+    vmiDisassAttrs attrs
+);
@@ -45,6 +45,7 @@
 #include "riscvMessage.h"
 #include "riscvMode.h"
 #include "riscvStructure.h"
+#include "riscvTrace.h"
 #include "riscvTrigger.h"
 #include "riscvUtils.h"
 #include "riscvVM.h"
@@ -1162,6 +1163,9 @@ void riscvTakeException(
             isInt     : isInterrupt(exception)
         };
 
+        // record exception in binary trace if required
+        riscvTraceException(riscv, ecode, cxt.isInt, cxt.EPC);
+
         // clear any active exclusive access if required
         if(!riscv->configInfo.trap_preserves_lr) {
             clearEA(riscv);
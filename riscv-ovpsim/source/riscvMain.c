@@ -31,7 +31,9 @@
 #include "riscvCLIC.h"
 #include "riscvCLINT.h"
 #include "riscvCluster.h"
+#include "riscvBranch.h"
 #include "riscvBus.h"
+#include "riscvCache.h"
 #include "riscvConfig.h"
 #include "riscvCSR.h"
 #include "riscvDebug.h"
@@ -43,7 +45,10 @@
 #include "riscvMessage.h"
 #include "riscvMorph.h"
 #include "riscvParameters.h"
+#include "riscvProfile.h"
 #include "riscvStructure.h"
+#include "riscvTiming.h"
+#include "riscvTrace.h"
 #include "riscvTrigger.h"
 #include "riscvUtils.h"
 #include "riscvVM.h"
@@ -728,8 +733,25 @@ static void applyParamsSMP(
     }
 
     // set simulation controls
-    riscv->verbose       = params->verbose;
-    riscv->traceVolatile = params->traceVolatile;
+    riscv->verbose         = params->verbose;
+    riscv->traceVolatile   = params->traceVolatile;
+    riscv->fusePairs       = params->fuse_pairs;
+    riscv->instrMix        = params->instruction_mix;
+    riscv->hotBlockFile    = params->hot_block_profile;
+    riscv->morphStats      = params->morph_statistics;
+    riscv->binaryTraceFile = params->binary_trace;
+    riscv->commitLogName   = params->commit_log;
+    riscv->memProfile      = params->memory_profile;
+    riscv->binTraceMem     = params->binary_trace_memory;
+    riscv->bbvFile         = params->bbv_file;
+    riscv->bbvInterval     = params->bbv_interval;
+    riscv->cycleLatency    = params->cycle_latency;
+    riscv->icacheSpec      = params->icache;
+    riscv->dcacheSpec      = params->dcache;
+    riscv->cacheSample     = params->cache_sample;
+    riscv->branchSpec      = params->branch_predictor;
+    riscv->vectorKernels   = params->vector_kernels;
+    riscv->vfredTree       = params->vfredusum_tree;
 
     // set data endian (instruction fetch is always little-endian)
     riscv->dendian = params->endian;
@@ -1567,6 +1589,18 @@ VMI_CONSTRUCTOR_FN(riscvConstructor) {
             riscvAddCSRCommands(riscv);
         }
 
+        // allocate profiling structures and commands
+        riscvNewProfile(riscv);
+
+        // allocate approximate timing structures
+        riscvNewTiming(riscv);
+
+        // allocate cache models and commands
+        riscvNewCache(riscv);
+
+        // allocate branch predictor model and commands
+        riscvNewBranch(riscv);
+
         // set hart index number within cluster
         riscv->hartNum = riscv->clusterRoot->numHarts++;
 
@@ -1574,6 +1608,10 @@ VMI_CONSTRUCTOR_FN(riscvConstructor) {
         if(riscv->smpRoot != riscv->clusterRoot) {
             riscv->smpRoot->numHarts++;
         }
+
+        // allocate instruction trace structures and commands (requires hart
+        // index)
+        riscvNewTrace(riscv);
     }
 }
 
@@ -1684,6 +1722,21 @@ static VMI_SMP_ITER_FN(perProcessorDestructor) {
 
     // free cluster variant structures
     riscvFreeClusterVariants(riscv);
+
+    // report and free profiling structures
+    riscvFreeProfile(riscv);
+
+    // flush and free instruction trace structures
+    riscvFreeTrace(riscv);
+
+    // free approximate timing structures
+    riscvFreeTiming(riscv);
+
+    // report and free cache models
+    riscvFreeCache(riscv);
+
+    // report and free branch predictor model
+    riscvFreeBranch(riscv);
 }
 
 //
@@ -31,6 +31,8 @@
 // model header files
 #include "riscvBExtension.h"
 #include "riscvBlockState.h"
+#include "riscvBranch.h"
+#include "riscvCache.h"
 #include "riscvCExtension.h"
 #include "riscvCSRTypes.h"
 #include "riscvDecode.h"
@@ -43,11 +45,15 @@
 #include "riscvMode.h"
 #include "riscvModelCallbackTypes.h"
 #include "riscvMorph.h"
+#include "riscvProfile.h"
 #include "riscvRegisters.h"
 #include "riscvStructure.h"
+#include "riscvTiming.h"
+#include "riscvTrace.h"
 #include "riscvTrigger.h"
 #include "riscvTypeRefs.h"
 #include "riscvUtils.h"
+#include "riscvVectorKernels.h"
 #include "riscvVM.h"
 
 
@@ -189,6 +195,7 @@ typedef struct riscvMorphAttrS {
     riscvMorphVFn         opTCB;            // element operation when mask=1
     riscvMorphVFn         opFCB;            // element operation when mask=0
     riscvMorphVFn         endCB;            // called at end of vector operation
+    riscvCheckVFn         kernelCB;         // called to implement operation with host kernel
     riscvOpCBFn           opCB;             // called to get operation callback
     octiaInstructionClass iClass;           // supplemental instruction class
     riscvBExtOpSet        bExtOp;           // B-extension operation set
@@ -1309,10 +1316,14 @@ static void updateFS(riscvP riscv) {
 
         riscvBlockStateP blockState = riscv->blockState;
 
-        // indicate that this instruction may update mstatus
-        mayUpdateMStatusFS(riscv);
-
+        // no action if an earlier instruction in this block has already set
+        // mstatus.FS to Dirty (the update and its register side effect
+        // indication are both redundant)
         if(!blockState->FSDirty) {
+
+            // indicate that this instruction may update mstatus
+            mayUpdateMStatusFS(riscv);
+
             blockState->FSDirty = True;
             emitSetMStatusMask(riscv, WM_mstatus_FS);
         }
@@ -1337,10 +1348,13 @@ static void updateVS(riscvP riscv) {
 
         riscvBlockStateP blockState = riscv->blockState;
 
-        // indicate that this instruction may update mstatus
-        mayUpdateMStatusVS(riscv);
-
+        // no action if an earlier instruction in this block has already set
+        // mstatus.VS to Dirty
         if(!blockState->VSDirty) {
+
+            // indicate that this instruction may update mstatus
+            mayUpdateMStatusVS(riscv);
+
             blockState->VSDirty = True;
             emitSetMStatusMask(riscv, WM_mstatus_VS);
         }
@@ -1719,11 +1733,20 @@ void riscvWriteRegSize(
 
         Uns32 dstArch = riscvGetXlenArch(riscv);
 
-        // sign-extend result to dstArch
-        vmimtMoveExtendRR(dstArch, dst, srcBits, dst, signExtend);
+        if(VMI_ISNOREG(dst)) {
+
+            // writes to x0 are discarded
 
-        // add to record of X registers written by this instruction
-        riscv->writtenXMask |= getRegMask(r);
+        } else {
+
+            // sign-extend result to dstArch if narrower
+            if(srcBits<dstArch) {
+                vmimtMoveExtendRR(dstArch, dst, srcBits, dst, signExtend);
+            }
+
+            // add to record of X registers written by this instruction
+            riscv->writtenXMask |= getRegMask(r);
+        }
 
     } else if(isFReg(r)) {
 
@@ -1747,6 +1770,9 @@ void riscvWriteRegSize(
             blockState->fpNaNBoxMask[i] |= fprMask;
         }
 
+        // add to record of F registers written by this instruction
+        riscv->writtenFMask |= fprMask;
+
         // set mstatus.FS
         updateFS(riscv);
 
@@ -2026,6 +2052,9 @@ void riscvWFS(riscvMorphStateP state, Bool useRS1) {
     riscvP riscv = state->riscv;
 
     updateFS(riscv);
+
+    // write of fflags or fcsr also sets per-instruction flags
+    riscv->blockState->FFlagsIZero = False;
 }
 
 //
@@ -2162,6 +2191,189 @@ inline static void writeUnpackedSize(unpackedReg rd, Uns32 srcBits) {
     writeRegSize(rd.state->riscv, rd.rA, srcBits);
 }
 
+//
+// Is the result of an instruction with no other side effects discarded because
+// the target is x0? (such instructions are NOPs or HINTs, so no code need be
+// generated once operand validity checks have been done)
+//
+inline static Bool isDiscardedResult(unpackedReg rd, vmiFlagsCP f) {
+    return isXReg(rd.rA) && VMI_ISNOREG(rd.r) && !f;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// INSTRUCTION PAIR FUSION
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Is fusion of common instruction pairs enabled? (NOTE: each instruction is
+// still translated separately, preserving precise exceptions and trace; the
+// second instruction of a recognized pair is translated using the known
+// result of the first)
+//
+inline static Bool fusePairs(riscvMorphStateP state) {
+    return state->riscv->fusePairs && !state->inDelaySlot;
+}
+
+//
+// Return index of unpacked GPR if it is a true GPR other than x0, or 0
+// otherwise
+//
+static Uns32 getFuseIndex(unpackedReg r) {
+    return (isXReg(r.rA) && !VMI_ISNOREG(r.r)) ? getRIndex(r.rA) : 0;
+}
+
+//
+// Return the result written by the previous instruction in this block if it
+// has the given kind, it targeted the given GPR and the operation size
+// matches, or NULL otherwise
+//
+static riscvFuseInfoP getFusePrev(
+    riscvMorphStateP state,
+    unpackedReg      r,
+    riscvFuseKind    kind
+) {
+    riscvFuseInfoP prev  = &state->riscv->blockState->fusePrev;
+    Uns32          index = getFuseIndex(r);
+
+    if(!fusePairs(state)) {
+        return 0;
+    } else if(!index || (prev->kind!=kind)) {
+        return 0;
+    } else if((prev->rd!=index) || (prev->bits!=r.bits)) {
+        return 0;
+    } else {
+        return prev;
+    }
+}
+
+//
+// Return an initialized record of the result of the current instruction for
+// use by the next instruction in the block, or NULL if fusion is disabled or
+// the target is not a true GPR
+//
+static riscvFuseInfoP newFuseNext(
+    riscvMorphStateP state,
+    unpackedReg      rd,
+    riscvFuseKind    kind
+) {
+    riscvFuseInfoP next  = &state->riscv->blockState->fuseNext;
+    Uns32          index = getFuseIndex(rd);
+
+    if(!fusePairs(state) || !index) {
+        return 0;
+    }
+
+    next->kind = kind;
+    next->rd   = index;
+    next->bits = rd.bits;
+
+    return next;
+}
+
+//
+// Record that the current instruction wrote a known constant to a GPR (the
+// value is held sign-extended from the operation size, as written)
+//
+static void setFuseConst(riscvMorphStateP state, unpackedReg rd, Uns64 value) {
+
+    riscvFuseInfoP next = newFuseNext(state, rd, RVFK_CONST);
+
+    if(next && (rd.bits<64)) {
+        next->value = ((Int64)(value<<(64-rd.bits)))>>(64-rd.bits);
+    } else if(next) {
+        next->value = value;
+    }
+}
+
+//
+// Return True if the given GPR is known to hold a constant (either x0, or
+// written with a constant by the previous instruction), filling the value
+//
+static Bool getKnownConst(
+    riscvMorphStateP state,
+    unpackedReg      r,
+    Uns64           *valueP
+) {
+    riscvFuseInfoP prev = getFusePrev(state, r, RVFK_CONST);
+
+    if(fusePairs(state) && isXReg(r.rA) && VMI_ISNOREG(r.r)) {
+        *valueP = 0;
+        return True;
+    } else if(prev) {
+        *valueP = prev->value;
+        return True;
+    } else {
+        return False;
+    }
+}
+
+//
+// Record that the current instruction wrote the given GPR shifted left
+//
+static void setFuseShift(
+    riscvMorphStateP state,
+    unpackedReg      rd,
+    unpackedReg      rs,
+    Uns32            shift
+) {
+    Uns32 rsIndex = getFuseIndex(rs);
+
+    // source must be preserved by the operation to be of later use
+    if(rsIndex && (rsIndex!=getFuseIndex(rd))) {
+
+        riscvFuseInfoP next = newFuseNext(state, rd, RVFK_SHL);
+
+        if(next) {
+            next->rs1   = rsIndex;
+            next->shift = shift;
+        }
+    }
+}
+
+//
+// Record that the current instruction wrote the result of a GPR comparison
+//
+static void setFuseCompare(
+    riscvMorphStateP state,
+    unpackedReg      rd,
+    unpackedReg      rs1,
+    unpackedReg      rs2,
+    vmiCondition     cond
+) {
+    Uns32 rdIndex = getFuseIndex(rd);
+
+    // sources must be preserved by the operation to be of later use
+    if(
+        (getRIndex(rs1.rA)!=rdIndex) &&
+        (getRIndex(rs2.rA)!=rdIndex)
+    ) {
+        riscvFuseInfoP next = newFuseNext(state, rd, RVFK_CMP);
+
+        if(next) {
+            next->rs1  = getRIndex(rs1.rA);
+            next->rs2  = getRIndex(rs2.rA);
+            next->cond = cond;
+        }
+    }
+}
+
+//
+// Return the inverse of a comparison condition used by slt/sltu
+//
+static vmiCondition invertCondition(vmiCondition cond) {
+
+    switch(cond) {
+        case vmi_COND_L:  return vmi_COND_NL;
+        case vmi_COND_NL: return vmi_COND_L;
+        case vmi_COND_B:  return vmi_COND_NB;
+        case vmi_COND_NB: return vmi_COND_B;
+        default:
+            VMI_ABORT("unexpected condition %u", cond); // LCOV_EXCL_LINE
+            return cond;
+    }
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 // LOAD/STORE UTILITIES
@@ -2323,18 +2535,30 @@ inline static Bool inTransactionMode(riscvP riscv) {
     return riscv->pmKey & PMK_TRANSACTION;
 }
 
+//
+// Return the polymorphic key that applies to the instruction being translated,
+// which differs from the key at block entry if vtype has been speculated after
+// vset{i}vl{i} within the block
+//
+inline static Uns32 getPMKeyMt(riscvP riscv) {
+
+    riscvBlockStateP blockState = riscv->blockState;
+
+    return blockState->VTypeSpecMt ? blockState->pmKeyMt : riscv->pmKey;
+}
+
 //
 // Return a Boolean indicating if vector tail elements must be set to 1
 //
 inline static Bool inVTA1Mode(riscvP riscv) {
-    return riscv->pmKey & PMK_VECTOR_VTA1;
+    return getPMKeyMt(riscv) & PMK_VECTOR_VTA1;
 }
 
 //
 // Return a Boolean indicating if vector masked-off elements must be set to 1
 //
 inline static Bool inVMA1Mode(riscvP riscv) {
-    return riscv->pmKey & PMK_VECTOR_VMA1;
+    return getPMKeyMt(riscv) & PMK_VECTOR_VMA1;
 }
 
 //
@@ -2517,6 +2741,22 @@ inline static void emitHLVHSV(Bool start) {
     vmimtMoveRC(8, RISCV_HLVHSV, start);
 }
 
+//
+// Emit code to record a load or store in the memory access profile and binary
+// trace if required
+//
+static void emitAccessRecord(
+    riscvP riscv,
+    vmiReg ra,
+    Uns64  offset,
+    Uns32  memBits,
+    Bool   isStore
+) {
+    riscvEmitProfileAccess(riscv, ra, offset, memBits, isStore);
+    riscvEmitTraceAccess(riscv, ra, offset, memBits, isStore);
+    riscvEmitCacheAccess(riscv, ra, offset, memBits, isStore);
+}
+
 //
 // Fundamental load operation
 //
@@ -2564,6 +2804,9 @@ void riscvEmitLoad(
         rdTmp = RISCV_TRIGGER_LV;
     }
 
+    // record access in memory access profile and trace if required
+    emitAccessRecord(riscv, ra, offset, memBits, False);
+
     // emit code to perform load
     emitLoadRRODomain(
         riscv, domain, rdBits, memBits, offset, rdTmp, ra, endian, sExtend,
@@ -2619,6 +2862,9 @@ void riscvEmitStore(
         emitTryStoreRC(riscv, memBits, offset, ra, constraint);
     }
 
+    // record access in memory access profile and trace if required
+    emitAccessRecord(riscv, ra, offset, memBits, True);
+
     // emit code to perform store
     emitStoreRRODomain(
         riscv, domain, memBits, offset, ra, rs, endian, constraint
@@ -2951,9 +3197,17 @@ static RISCV_MORPH_FN(emitMoveRC) {
     Uns64       c    = state->info.c;
     Uns32       bits = rd.bits;
 
+    // no action for HINT
+    if(isDiscardedResult(rd, 0)) {
+        return;
+    }
+
     vmimtMoveRC(bits, rd.r, c);
 
     writeUnpacked(rd);
+
+    // record known constant for use by next instruction
+    setFuseConst(state, rd, c);
 }
 
 //
@@ -2965,6 +3219,11 @@ static RISCV_MORPH_FN(emitMoveRPC) {
     Uns64       c    = state->info.c;
     Uns32       bits = rd.bits;
 
+    // no action for HINT
+    if(isDiscardedResult(rd, 0)) {
+        return;
+    }
+
     // when in a delayed instruction context, base on that address
     if(state->inDelaySlot) {
         vmimtMoveRR(bits, rd.r, RISCV_JUMP_BASE);
@@ -2975,6 +3234,11 @@ static RISCV_MORPH_FN(emitMoveRPC) {
     vmimtBinopRC(bits, state->attrs->binop, rd.r, c, 0);
 
     writeUnpacked(rd);
+
+    // record known constant for use by next instruction (e.g. auipc+jalr)
+    if(state->attrs->binop==vmi_ADD) {
+        setFuseConst(state, rd, state->info.thisPC+c);
+    }
 }
 
 //
@@ -2988,10 +3252,13 @@ static RISCV_MORPH_FN(emitUnopRR) {
     vmiFlagsCP  f    = getUnopSatFlags(state, op);
     Uns32       bits = rd.bits;
 
-    vmimtUnopRR(bits, op, rd.r, rs1.r, f);
-    commitSatFlag(state, f);
+    if(!isDiscardedResult(rd, f)) {
 
-    writeUnpacked(rd);
+        vmimtUnopRR(bits, op, rd.r, rs1.r, f);
+        commitSatFlag(state, f);
+
+        writeUnpacked(rd);
+    }
 }
 
 //
@@ -3006,10 +3273,13 @@ static RISCV_MORPH_FN(emitBinopRRR) {
     vmiFlagsCP  f    = getBinopSatFlags(state, op);
     Uns32       bits = rd.bits;
 
-    vmimtBinopRRR(bits, op, rd.r, rs1.r, rs2.r, f);
-    commitSatFlag(state, f);
+    if(!isDiscardedResult(rd, f)) {
 
-    writeUnpacked(rd);
+        vmimtBinopRRR(bits, op, rd.r, rs1.r, rs2.r, f);
+        commitSatFlag(state, f);
+
+        writeUnpacked(rd);
+    }
 }
 
 //
@@ -3037,9 +3307,53 @@ static RISCV_MORPH_FN(emitCmpopRRR) {
     unpackedReg rs2  = unpackRX(state, 2);
     Uns32       bits = rd.bits;
 
+    // no action for HINT
+    if(isDiscardedResult(rd, 0)) {
+        return;
+    }
+
     vmimtCompareRR(bits, state->attrs->cond, rs1.r, rs2.r, rd.r);
 
     writeUnpackedSize(rd, 8);
+
+    // record comparison for use by next instruction (e.g. slt+bnez)
+    if((state->attrs->cond==vmi_COND_L) || (state->attrs->cond==vmi_COND_B)) {
+        setFuseCompare(state, rd, rs1, rs2, state->attrs->cond);
+    }
+}
+
+//
+// If the instruction is a right shift of a GPR shifted left by the same amount
+// by the previous instruction (slli+srli or slli+srai) and the remaining width
+// is a supported extension size, emit it as a single extension of the original
+// GPR and return True
+//
+static Bool emitFuseExtend(
+    riscvMorphStateP state,
+    unpackedReg      rd,
+    unpackedReg      rs1,
+    Uns64            c
+) {
+    riscvIType     type    = state->info.type;
+    Int32          extBits = rd.bits-c;
+    riscvFuseInfoP prev;
+
+    if((type!=RV_IT_SRLI_I) && (type!=RV_IT_SRAI_I)) {
+        return False;
+    } else if((extBits!=8) && (extBits!=16) && (extBits!=32)) {
+        return False;
+    } else if(!(prev=getFusePrev(state, rs1, RVFK_SHL)) || (prev->shift!=c)) {
+        return False;
+    } else {
+
+        unpackedReg rs = createRX(state, prev->rs1);
+
+        vmimtMoveExtendRR(rd.bits, rd.r, extBits, rs.r, type==RV_IT_SRAI_I);
+
+        writeUnpacked(rd);
+
+        return True;
+    }
 }
 
 //
@@ -3053,11 +3367,36 @@ static RISCV_MORPH_FN(emitBinopRRC) {
     vmiFlagsCP  f    = getBinopSatFlags(state, op);
     Uns64       c    = state->info.c;
     Uns32       bits = rd.bits;
+    Uns64       value;
 
-    vmimtBinopRRC(bits, op, rd.r, rs1.r, c, f);
-    commitSatFlag(state, f);
+    if(isDiscardedResult(rd, f)) {
 
-    writeUnpacked(rd);
+        // NOP or HINT
+
+    } else if((op==vmi_ADD) && !f && getKnownConst(state, rs1, &value)) {
+
+        // fused with preceding constant write (e.g. lui+addi, auipc+addi)
+        value += c;
+        vmimtMoveRC(bits, rd.r, value);
+        writeUnpacked(rd);
+        setFuseConst(state, rd, value);
+
+    } else if(emitFuseExtend(state, rd, rs1, c)) {
+
+        // fused with preceding left shift (slli+srli, slli+srai)
+
+    } else {
+
+        vmimtBinopRRC(bits, op, rd.r, rs1.r, c, f);
+        commitSatFlag(state, f);
+
+        writeUnpacked(rd);
+
+        // record shift for use by next instruction
+        if(state->info.type==RV_IT_SLLI_I) {
+            setFuseShift(state, rd, rs1, c);
+        }
+    }
 }
 
 //
@@ -3070,9 +3409,12 @@ static RISCV_MORPH_FN(emitCmpopRRC) {
     Uns64       c    = state->info.c;
     Uns32       bits = rd.bits;
 
-    vmimtCompareRC(bits, state->attrs->cond, rs1.r, c, rd.r);
+    if(!isDiscardedResult(rd, 0)) {
 
-    writeUnpackedSize(rd, 8);
+        vmimtCompareRC(bits, state->attrs->cond, rs1.r, c, rd.r);
+
+        writeUnpackedSize(rd, 8);
+    }
 }
 
 //
@@ -3290,10 +3632,52 @@ static void emitBranchRX(riscvMorphStateP state, vmiReg tmp) {
         vmimtInsertLabel(noBranch);
     }
 
+    // simulate branch prediction if required
+    riscvEmitBranchConditional(riscv, tgt, tmp);
+
     // do branch
     vmimtCondJump(tmp, True, 0, tgt, VMI_NOREG, vmi_JH_RELATIVE);
 }
 
+//
+// If the instruction is a test against zero of a comparison result written by
+// the previous instruction (e.g. slt+bnez), emit the comparison of the
+// original operands instead and return True
+//
+static Bool emitFuseCompare(
+    riscvMorphStateP state,
+    unpackedReg      rs1,
+    unpackedReg      rs2,
+    vmiReg           tmp
+) {
+    vmiCondition   cond = state->attrs->cond;
+    riscvFuseInfoP prev = 0;
+
+    if((cond!=vmi_COND_EQ) && (cond!=vmi_COND_NE)) {
+        // not a test of a comparison result
+    } else if(!getFuseIndex(rs2)) {
+        prev = getFusePrev(state, rs1, RVFK_CMP);
+    } else if(!getFuseIndex(rs1)) {
+        prev = getFusePrev(state, rs2, RVFK_CMP);
+    }
+
+    if(prev) {
+
+        unpackedReg  a     = createRX(state, prev->rs1);
+        unpackedReg  b     = createRX(state, prev->rs2);
+        vmiCondition fused = prev->cond;
+
+        // branch if comparison result is zero requires inverted condition
+        if(cond==vmi_COND_EQ) {
+            fused = invertCondition(fused);
+        }
+
+        vmimtCompareRR(a.bits, fused, a.r, b.r, tmp);
+    }
+
+    return prev!=0;
+}
+
 //
 // Branch based on register comparison
 //
@@ -3304,8 +3688,10 @@ static RISCV_MORPH_FN(emitBranchRR) {
     Uns32       bits = rs1.bits;
     vmiReg      tmp  = newTmp(state);
 
-    // do comparison
-    vmimtCompareRR(bits, state->attrs->cond, rs1.r, rs2.r, tmp);
+    // do comparison (possibly fused with the previous instruction)
+    if(!emitFuseCompare(state, rs1, rs2, tmp)) {
+        vmimtCompareRR(bits, state->attrs->cond, rs1.r, rs2.r, tmp);
+    }
 
     // common branch code
     emitBranchRX(state, tmp);
@@ -3363,6 +3749,7 @@ static RISCV_MORPH_FN(emitJAL) {
 
     // emit call using calculated linkPC and adjusted lr
     Uns64 linkPC = getLinkPC(state, &lr.r);
+    riscvEmitBranchJump(riscv, VMI_NOREG, 0, tgt, linkPC, hint, False);
     vmimtUncondJump(linkPC, tgt, lr.r, hint|vmi_JH_RELATIVE);
 }
 
@@ -3388,9 +3775,49 @@ static void emitJALRInt(riscvMorphStateP state, vmiReg ra, unpackedReg lr) {
 
     // emit call using calculated linkPC and adjusted lr
     Uns64 linkPC = getLinkPC(state, &lr.r);
+    riscvEmitBranchJump(state->riscv, ra, bits, 0, linkPC, hint, True);
     vmimtUncondJumpReg(linkPC, ra, lr.r, hint|vmi_JH_RELATIVE);
 }
 
+//
+// Emit indirect jump-and-link when the target register is known to hold a
+// constant (e.g. auipc+jalr), allowing a direct jump to be used
+//
+static void emitJALRConst(
+    riscvMorphStateP state,
+    unpackedReg      ra,
+    unpackedReg      lr,
+    Uns64            value,
+    Uns64            offset
+) {
+    riscvP      riscv = state->riscv;
+    Uns64       tgt   = value+offset;
+    vmiJumpHint hint;
+
+    // target address bit 0 is cleared and is truncated to XLEN
+    tgt &= getAddressMask(ra.bits) & -2;
+
+    // validate target address alignment
+    if(!isTargetAddressAlignedC(riscv, tgt)) {
+        emitTargetAddressUnalignedC(riscv, tgt);
+    }
+
+    // derive jump hint as emitJALRInt does (a nonzero offset means the jump
+    // is not through a link register, e.g. auipc ra,hi; jalr ra,lo(ra))
+    if(isLR(ra.r) && !offset) {
+        hint = vmi_JH_RETURN;
+    } else if(isLR(lr.r)) {
+        hint = vmi_JH_CALL;
+    } else {
+        hint = vmi_JH_NONE;
+    }
+
+    // emit call using calculated linkPC and adjusted lr
+    Uns64 linkPC = getLinkPC(state, &lr.r);
+    riscvEmitBranchJump(riscv, VMI_NOREG, 0, tgt, linkPC, hint, True);
+    vmimtUncondJump(linkPC, tgt, lr.r, hint|vmi_JH_RELATIVE);
+}
+
 //
 // Jump to register target address
 //
@@ -3398,6 +3825,13 @@ static RISCV_MORPH_FN(emitJALR) {
 
     unpackedReg ra     = unpackRX(state, 1);
     Uns64       offset = state->info.c;
+    Uns64       value;
+
+    // use direct jump if target register is known to be constant
+    if(getKnownConst(state, ra, &value)) {
+        emitJALRConst(state, ra, unpackRX(state, 0), value, offset);
+        return;
+    }
 
     // calculate target address if required
     if(offset) {
@@ -5673,8 +6107,11 @@ inline static vmiFPRC mapRMDescToRC(riscvRMDesc rm) {
 //
 vmiReg riscvGetFPFlagsMT(riscvP riscv) {
 
-    // indicate that this instruction may update mstatus
-    mayUpdateMStatusFS(riscv);
+    // indicate that this instruction may update mstatus (not required if
+    // mstatus.FS is already known to be Dirty in this block)
+    if(!riscv->blockState->FSDirty) {
+        mayUpdateMStatusFS(riscv);
+    }
 
     // set mstatus.FS if required
     if(writeAnyFS(riscv)) {
@@ -5691,6 +6128,7 @@ vmiReg riscvGetFPFlagsMT(riscvP riscv) {
         // indicate per-instruction floating point flags are written
         vmimtRegWriteImpl("fflags_i");
         riscv->blockState->updateFFlags = True;
+        riscv->blockState->FFlagsIZero  = False;
 
         // update per-instruction flags
         return RISCV_FP_FLAGS_I;
@@ -6980,15 +7418,33 @@ static RISCV_MORPH_FN(emitDECBNEZ) {
 // VECTOR UNIT CONFIGURATION
 ////////////////////////////////////////////////////////////////////////////////
 
+//
+// Zero-valued vector registers shared by all harts until vector state is first
+// enabled or written (pages of this are never written, so they remain shared)
+//
+static Uns32 zeroVRegs[(VLEN_MAX/32)*VREG_NUM];
+
 //
 // Configure vector extension
 //
 void riscvConfigureVector(riscvP riscv) {
 
+    // use shared zero vector registers until allocation is required
+    if(vectorPresent(riscv)) {
+        riscv->v = zeroVRegs;
+    }
+}
+
+//
+// Allocate vector registers for a hart if they are still shared zero values
+// (this must be done before the address of any vector register is used in
+// translated code)
+//
+void riscvAllocVector(riscvP riscv) {
+
     Uns32 vRegBytes = riscv->configInfo.VLEN/8;
 
-    // allocate vector registers if required
-    if(vectorPresent(riscv)) {
+    if(riscv->v==zeroVRegs) {
         riscv->v = STYPE_CALLOC_N(Uns32, (vRegBytes/4)*VREG_NUM);
     }
 }
@@ -6999,10 +7455,11 @@ void riscvConfigureVector(riscvP riscv) {
 void riscvFreeVector(riscvP riscv) {
 
     // free vector registers if required
-    if(riscv->v) {
+    if(riscv->v && (riscv->v!=zeroVRegs)) {
     	STYPE_FREE(riscv->v);
-    	riscv->v = 0;
     }
+
+    riscv->v = 0;
 }
 
 
@@ -7057,6 +7514,8 @@ typedef struct iterDescS {
     Uns8           vregs;               // number of registers affected
     Bool           forceSEW;            // whether SEW is forced
     Bool           isScalar;            // is operation scalar?
+    Bool           redTree;             // reduction uses partial sums?
+    Bool           maskedOffSet;        // masked-off elements already set?
     riscvRegDesc   PdA;                 // predicate abstract target register
     vmiReg         mask;                // mask register
     vmiReg         rdNarrow;            // narrow destination register
@@ -7065,6 +7524,7 @@ typedef struct iterDescS {
     baseDesc       base[NUM_BASE_REGS]; // base registers
     vmiLabelP      maskF;               // target if mask=0
     vmiLabelP      skip;                // target if body is skipped
+    vmiLabelP      kernelDone;          // target if bulk kernel completes
 } iterDesc;
 
 //
@@ -7820,9 +8280,8 @@ static Bool isFloat(riscvVShape vShape) {
 //
 // Get effective vector length multiplier
 //
-static riscvVLMULx8Mt getVLMULMt(riscvMorphStateP state) {
+riscvVLMULx8Mt riscvGetVLMULx8Mt(riscvP riscv) {
 
-    riscvP           riscv      = state->riscv;
     riscvBlockStateP blockState = riscv->blockState;
     riscvVLMULx8Mt   VLMULx8    = blockState->VLMULx8Mt;
 
@@ -8976,6 +9435,27 @@ static riscvMorphVFn getInitEndCB(
     return initEndCB;
 }
 
+//
+// Add the destination register group of a vector operation to the record of
+// V registers written by this instruction
+//
+static void recordWrittenV(riscvMorphStateP state, iterDescP id) {
+
+    riscvP       riscv = state->riscv;
+    riscvRegDesc rD    = getRVReg(state, 0);
+
+    if(isR0Dst(state->attrs->vShape) && isVReg(rD)) {
+
+        Uns32 index  = getRIndex(rD);
+        Uns32 regNum = getVRegNum(state, id, 0);
+        Uns32 i;
+
+        for(i=0; (i<regNum) && ((i+index)<VREG_NUM); i++) {
+            riscv->writtenVMask |= (1<<(i+index));
+        }
+    }
+}
+
 //
 // Do actions at the start of a vector operation
 //
@@ -8986,6 +9466,9 @@ static void startVectorOp(riscvMorphStateP state, iterDescP id, Bool iterVStart)
     // set vector state to dirty if required
     updateVS(state->riscv);
 
+    // add to record of V registers written by this instruction
+    recordWrittenV(state, id);
+
     // handle non-zero vstart
     id->skip = handleNonZeroVStart(state, id, iterVStart);
 
@@ -9153,6 +9636,8 @@ static riscvMorphVFn getUnmaskedCB(riscvMorphStateP state, iterDescP id) {
         // no action unless T/F behaviors differ
     } else if(!inVMA1Mode(state->riscv)) {
         // no action unless vtype.vma=1 and masked-off elements must be set to 1
+    } else if(id->maskedOffSet) {
+        // no action if masked-off elements were set before the loop
     } else if(!isR0Dst(vShape)) {
         // no action unless operation sets a result
     } else if(isUnindexedN(vShape, 0)) {
@@ -9367,11 +9852,69 @@ static void zeroVdPdTailBLT(
 }
 
 //
-// Fill tail of predicate and vector target registers if required
+// Can the per-element tail fill algorithm be replaced by a bulk host kernel?
+// This requires one bit per mask element in whole 64-bit words, or vector
+// elements of at least one byte that are not striped
 //
-static vmiLabelP setVdPdTail(riscvMorphStateP state, iterDescP id) {
+static Bool useVKFillTail(
+    riscvMorphStateP state,
+    iterDescP        id,
+    Bool             setPd,
+    Uns32            setVd
+) {
+    riscvP riscv = state->riscv;
 
-    riscvRegDesc PdA   = id->PdA;
+    if(!riscv->vectorKernels || (id->VLEN%64)) {
+        return False;
+    } else if(setPd) {
+        return !setVd && (id->MLEN==1);
+    } else {
+        return (getEEW(id, 0)>=8) && !isIndexedVRegisterStriped(id, 0);
+    }
+}
+
+//
+// Fill tail of predicate or vector target registers using bulk host kernel
+//
+static void setVdPdTailVK(
+    riscvMorphStateP state,
+    iterDescP        id,
+    Bool             setPd,
+    Uns32            setVd
+) {
+    Bool ones = state->riscv->configInfo.agnostic_ones;
+
+    vmimtArgProcessor();
+
+    if(setPd) {
+
+        vmimtArgUns32(getRIndex(id->PdA));
+        vmimtArgReg(32, CSR_REG_MT(vstart));
+        vmimtArgUns32(id->VLEN/id->MLEN);
+        vmimtArgUns32(ones);
+        vmimtCall((vmiCallFn)riscvVKFillMaskTail);
+
+    } else {
+
+        Uns32 EEW = getEEW(id, 0);
+
+        vmimtArgUns32(getRIndex(getRVReg(state, 0)));
+        vmimtArgUns32(EEW);
+        vmimtArgUns32(getEMUL(id, 0));
+        vmimtArgUns32(setVd);
+        vmimtArgReg(32, CSR_REG_MT(vstart));
+        vmimtArgUns32((id->VLEN*id->vregs)/EEW);
+        vmimtArgUns32(ones);
+        vmimtCall((vmiCallFn)riscvVKFillTail);
+    }
+}
+
+//
+// Fill tail of predicate and vector target registers if required
+//
+static vmiLabelP setVdPdTail(riscvMorphStateP state, iterDescP id) {
+
+    riscvRegDesc PdA   = id->PdA;
     riscvRegDesc VdA   = getRVReg(state, 0);
     Bool         setPd = requireTailSet(state, id, PdA, 1);
     Uns32        setVd = 0;
@@ -9408,7 +9951,11 @@ static vmiLabelP setVdPdTail(riscvMorphStateP state, iterDescP id) {
             (setPd && (id->MLEN<8)) ||
             (setVd && isIndexedVRegisterStriped(id, 0))
         ) {
-            setVdPdTailPE(state, id, setPd, setVd);
+            if(useVKFillTail(state, id, setPd, setVd)) {
+                setVdPdTailVK(state, id, setPd, setVd);
+            } else {
+                setVdPdTailPE(state, id, setPd, setVd);
+            }
         } else {
             zeroVdPdTailBLT(state, id, setPd, setVd);
         }
@@ -9551,13 +10098,20 @@ static void doPerElementOp(riscvMorphStateP state, iterDescP id) {
 //
 static Bool emitCheckVILL(riscvMorphStateP state) {
 
-    Bool vill = RD_CSR_FIELD_U(state->riscv, vtype, vill) && !state->info.isWhole;
+    riscvP riscv = state->riscv;
+
+    // vtype speculated within the block is always legal
+    Bool vill = (
+        !riscv->blockState->VTypeSpecMt &&
+        RD_CSR_FIELD_U(riscv, vtype, vill) &&
+        !state->info.isWhole
+    );
 
     // indicate this is a vector instruction
     vmimtInstructionClassAdd(OCL_IC_VECTOR);
 
     if(vill) {
-        ILLEGAL_INSTRUCTION_MESSAGE(state->riscv, "VILL", "vtype.vill=1");
+        ILLEGAL_INSTRUCTION_MESSAGE(riscv, "VILL", "vtype.vill=1");
     }
 
     return !vill;
@@ -9598,7 +10152,7 @@ static riscvVLClassMt fillVectorOperationData(
         id->nf      = 0;
         vlClass     = VLCLASSMT_MAX;
     } else {
-        id->VLMULx8 = getVLMULMt(state);
+        id->VLMULx8 = riscvGetVLMULx8Mt(riscv);
         id->VLEN    = riscv->configInfo.VLEN;
         id->SEW     = riscvGetSEWMt(riscv);
         id->SLEN    = riscv->configInfo.SLEN;
@@ -9702,6 +10256,177 @@ static Bool emitVFREDSUMCB(riscvMorphStateP state, iterDescP id) {
     return result;
 }
 
+//
+// Can the vector operation be implemented by a bulk host kernel? Kernels
+// require that operands are not striped and that mask registers hold one bit
+// per element in whole 64-bit words
+//
+static Bool useVectorKernel(riscvMorphStateP state, iterDescP id) {
+
+    riscvP riscv = state->riscv;
+
+    return (
+        riscv->vectorKernels  &&
+        vectorMLEN1(riscv)    &&
+        (id->SLEN==id->VLEN)  &&
+        !(id->VLEN%64)        &&
+        (id->EGS==1)
+    );
+}
+
+//
+// Emit code to implement entire vector operation using a bulk host kernel if
+// possible. A kernel callback that can complete only part of the operation at
+// run time returns False and sets id->kernelDone as the target to use when no
+// elements remain for the per-element loop
+//
+static Bool emitVectorKernel(riscvMorphStateP state, iterDescP id) {
+
+    riscvCheckVFn kernelCB = state->attrs->kernelCB;
+    Bool          result   = False;
+
+    if(kernelCB && useVectorKernel(state, id)) {
+
+        result = kernelCB(state, id);
+
+        // all body elements have been processed, so tail starts at vl
+        if(result) {
+            clampVStart(state, id);
+        }
+    }
+
+    return result;
+}
+
+//
+// Return flags for a bulk host kernel call
+//
+static riscvVKFlags getVKFlags(riscvMorphStateP state, iterDescP id) {
+
+    riscvVKFlags flags = 0;
+
+    if(!VMI_ISNOREG(id->mask)) {
+
+        flags |= RVVK_MASKED;
+
+        if(inVMA1Mode(state->riscv)) {
+            flags |= RVVK_VMA1;
+        }
+    }
+
+    return flags;
+}
+
+//
+// Operand index indicating an absent bulk kernel operand
+//
+#define VK_NO_ARG ((Uns32)-1)
+
+//
+// Emit register index argument for a bulk host kernel call
+//
+inline static void emitVKRegArg(riscvMorphStateP state, Uns32 argNum) {
+    vmimtArgUns32(getRIndex(getRVReg(state, argNum)));
+}
+
+//
+// Emit vstart and vl arguments for a bulk host kernel call
+//
+static void emitVKRangeArgs(riscvMorphStateP state, iterDescP id) {
+
+    vmimtArgReg(32, CSR_REG_MT(vstart));
+
+    if(state->info.isWhole) {
+        vmimtArgUns32(getVLMAXOp(id));
+    } else {
+        vmimtArgReg(32, getEVLRegMT(state));
+    }
+}
+
+//
+// Does the destination register group of a masked operation overlap v0? Bulk
+// kernels read the mask a word at a time, so the per-element implementation is
+// used in this case
+//
+static Bool vdOverlapsV0(riscvMorphStateP state, iterDescP id) {
+    return !VMI_ISNOREG(id->mask) && !getRIndex(getRVReg(state, 0));
+}
+
+//
+// Does the destination register group overlap any vector source register
+// group?
+//
+static Bool vdOverlapsSource(riscvMorphStateP state, iterDescP id) {
+
+    Uns32 vdLo = getRIndex(getRVReg(state, 0));
+    Uns32 vdHi = vdLo + getEMUL(id, 0);
+    Uns32 srcNum;
+
+    for(srcNum=1; srcNum<RV_MAX_AREGS; srcNum++) {
+
+        riscvRegDesc rA = getRVReg(state, srcNum);
+
+        if(isVReg(rA)) {
+
+            Uns32 vsLo = getRIndex(rA);
+            Uns32 vsHi = vsLo + getEMUL(id, srcNum);
+
+            if((vsLo<vdHi) && (vdLo<vsHi)) {
+                return True;
+            }
+        }
+    }
+
+    return False;
+}
+
+//
+// Can masked-off destination elements be set to all-ones by a bulk host
+// kernel before the per-element loop? This requires that the destination is a
+// simple vector register group that no element operation reads
+//
+static Bool useVKFillMaskedOff(riscvMorphStateP state, iterDescP id) {
+
+    riscvMorphAttrCP attrs  = state->attrs;
+    riscvVShape      vShape = attrs->vShape;
+
+    return (
+        useVectorKernel(state, id)               &&
+        !VMI_ISNOREG(id->mask)                   &&
+        !isMaskCIn(vShape)                       &&
+        inVMA1Mode(state->riscv)                 &&
+        !attrs->opFCB                            &&
+        (attrs->vstart0!=RVVST_LD_ST)            &&
+        isR0Dst(vShape)                          &&
+        !isUnindexedN(vShape, 0)                 &&
+        !isScalarN(vShape, 0)                    &&
+        !isNarrowing(vShape)                     &&
+        (getSEWMultiplier(vShape)==1)            &&
+        !id->PdA                                 &&
+        (getEEW(id, 0)>=8)                       &&
+        !vdOverlapsV0(state, id)                 &&
+        !vdOverlapsSource(state, id)
+    );
+}
+
+//
+// Emit code to set masked-off destination elements to all-ones before the
+// per-element loop if possible, so that the loop can skip them
+//
+static void emitVKFillMaskedOff(riscvMorphStateP state, iterDescP id) {
+
+    if(useVKFillMaskedOff(state, id)) {
+
+        vmimtArgProcessor();
+        emitVKRegArg(state, 0);
+        vmimtArgUns32(getEEW(id, 0));
+        emitVKRangeArgs(state, id);
+        vmimtCall((vmiCallFn)riscvVKFillMaskedOff);
+
+        id->maskedOffSet = True;
+    }
+}
+
 /*
 //
 // Emit code to implement entire vector operation externally if required
@@ -9762,12 +10487,23 @@ static RISCV_MORPH_FN(emitVectorOp) {
             // start a new vector operation
             startVectorOp(state, &id, True);
 
-            if(!emitVFREDSUMCB(state, &id)) {
+            if(emitVFREDSUMCB(state, &id)) {
+
+                // implemented by custom callback
+
+            } else if(emitVectorKernel(state, &id)) {
+
+                // implemented by bulk host kernel
+
+            } else {
 
                 vmiLabelP   loop   = vmimtNewLabel();
                 riscvVShape vShape = state->attrs->vShape;
                 Uns32       SEWMul = getSEWMultiplier(vShape);
 
+                // set masked-off elements in bulk if possible
+                emitVKFillMaskedOff(state, &id);
+
                 // loop to here
                 vmimtInsertLabel(loop);
 
@@ -9791,6 +10527,11 @@ static RISCV_MORPH_FN(emitVectorOp) {
 
                 // repeat until done
                 endVectorLoop(state, &id, loop);
+
+                // here if a bulk kernel processed all elements
+                if(id.kernelDone) {
+                    vmimtInsertLabel(id.kernelDone);
+                }
             }
 
             // perform actions at end of instruction
@@ -10091,14 +10832,105 @@ static void emitVSetVLRRRCB(riscvMorphStateP state) {
     vmimtEndBlock();
 }
 
+//
+// Return the vl class to assume for the remainder of the block after
+// VSetVL <rd>, <rs1>, <vtypei>, or VLCLASSMT_UNKNOWN if the block should be
+// terminated instead
+//
+static riscvVLClassMt getSpeculatedVLClass(riscvMorphStateP state) {
+
+    riscvP      riscv  = state->riscv;
+    setVLOption option = getSetVLOption(state);
+
+    if(option==SVT_MAX) {
+
+        // vl is set to VLMAX
+        return VLCLASSMT_MAX;
+
+    } else if(option==SVT_PRESERVE) {
+
+        // preserved vl is not known
+        return VLCLASSMT_UNKNOWN;
+
+    } else if(getRVReg(state, 1)) {
+
+        // assume a strip-mined loop in which most iterations use VLMAX
+        return VLCLASSMT_MAX;
+
+    } else {
+
+        // vl is derived from uimm (vsetivli)
+        Uns64 avl   = state->info.c;
+        Uns32 VLMAX = riscvGetMaxVL(riscv, state->info.vtype);
+
+        if(!avl) {
+            return VLCLASSMT_ZERO;
+        } else if(avl>=VLMAX) {
+            return VLCLASSMT_MAX;
+        } else {
+            return VLCLASSMT_NONZERO;
+        }
+    }
+}
+
+//
+// Continue the block after VSetVL <rd>, <rs1>, <vtypei> with vtype known and
+// vl class speculated, instead of terminating it. If the vl class is not
+// certain, emit code that leaves the block at the next instruction if the
+// polymorphic key at run time differs from the speculated one, so that the
+// remainder is translated for the true key
+//
+static void speculateVTypeVL(riscvMorphStateP state, riscvVLClassMt vlClass) {
+
+    riscvP           riscv      = state->riscv;
+    riscvBlockStateP blockState = riscv->blockState;
+    riscvVType       vtype      = state->info.vtype;
+    riscvVLMULx8Mt   VLMULx8    = vtypeToVLMULx8(vtype);
+    Uns32            vecKey     = riscvGetVectorPMKey(riscv, vtype, vlClass);
+
+    if(getSetVLOption(state)!=SVT_MAX) {
+
+        vmiReg tmp    = newTmp(state);
+        Uns64  nextPC = state->info.thisPC + state->info.bytes;
+
+        // leave the block if the vector key does not match
+        vmimtBinopRRC(16, vmi_AND, tmp, RISCV_PM_KEY, PMK_VECTOR, 0);
+        vmimtCompareRC(16, vmi_COND_NE, tmp, vecKey, tmp);
+        vmimtCondJump(tmp, True, 0, nextPC, VMI_NOREG, vmi_JH_NONE);
+
+        freeTmp(state);
+    }
+
+    // reset knowledge of registers that have top parts set unless previous
+    // configuration had the same VLMUL and was also set to maximum size
+    if(
+        (vlClass               != VLCLASSMT_MAX) ||
+        (blockState->VLClassMt != VLCLASSMT_MAX) ||
+        (blockState->VLMULx8Mt != VLMULx8)
+    ) {
+        blockState->VSetTopMt[VTZ_SINGLE] = 0;
+        blockState->VSetTopMt[VTZ_GROUP]  = 0;
+    }
+
+    // update morph-time VLClass, SEW, VLMUL, vma and vta which are now known
+    blockState->VLClassMt   = vlClass;
+    blockState->SEWMt       = getVTypeSEW(vtype);
+    blockState->VLMULx8Mt   = VLMULx8;
+    blockState->vtaMt       = getVTypeVTA(vtype);
+    blockState->vmaMt       = getVTypeVMA(vtype);
+    blockState->VTypeSpecMt = True;
+    blockState->pmKeyMt     = (riscv->pmKey & ~PMK_VECTOR) | vecKey;
+}
+
 //
 // Emit VSetVL <rd>, <rs1>, <vtypei> embedded function call
 //
 static void emitVSetVLRRCCB(riscvMorphStateP state) {
 
-    unpackedReg rd    = unpackRX(state, 0);
-    riscvVType  vtype = state->info.vtype;
-    Uns32       dBits = 32;
+    unpackedReg    rd      = unpackRX(state, 0);
+    riscvVType     vtype   = state->info.vtype;
+    Uns32          dBits   = 32;
+    riscvVLClassMt vlClass = getSpeculatedVLClass(state);
 
     // call update function (SEW is known to be valid)
     vmiCallFn cb = handleVSetVLArg1(state);
@@ -10106,9 +10938,17 @@ static void emitVSetVLRRCCB(riscvMorphStateP state) {
     vmimtCallResultAttrs(cb, dBits, rd.r, VMCA_NO_INVALIDATE);
     writeUnpackedSize(rd, dBits);
 
-    // terminate the block after this instruction because polymorphic state
-    // differs from initial state
-    vmimtEndBlock();
+    if(vlClass==VLCLASSMT_UNKNOWN) {
+
+        // terminate the block after this instruction because polymorphic
+        // state differs from initial state
+        vmimtEndBlock();
+
+    } else {
+
+        // continue the block with the new polymorphic state
+        speculateVTypeVL(state, vlClass);
+    }
 }
 
 //
@@ -10165,25 +11005,9 @@ static void emitVSetVLRR0MaxVL(riscvMorphStateP state) {
 
     } else {
 
-        // update to possibly different configuration
+        // update to possibly different configuration (this also updates
+        // morph-time VLClass, SEW, VLMUL, vma and vta which are now known)
         emitVSetVLRRCCB(state);
-
-        // reset knowledge of registers that have top parts set unless previous
-        // configuration had the same VLMUL and was also set to maximum size
-        if(
-            (blockState->VLClassMt != VLCLASSMT_MAX) ||
-            (blockState->VLMULx8Mt != VLMULx8)
-        ) {
-            blockState->VSetTopMt[VTZ_SINGLE] = 0;
-            blockState->VSetTopMt[VTZ_GROUP]  = 0;
-        }
-
-        // update morph-time VLClass, SEW, VLMUL, vma and vta which are now known
-        blockState->VLClassMt = VLCLASSMT_MAX;
-        blockState->SEWMt     = SEW;
-        blockState->VLMULx8Mt = VLMULx8;
-        blockState->vtaMt     = vta;
-        blockState->vmaMt     = vma;
     }
 }
 
@@ -10801,6 +11625,204 @@ static RISCV_MORPHV_FN(emitVStICB) {
     emitVStInt(state, id, emitVLdStIOffset(state, id));
 }
 
+//
+// This enumerates load/store address calculations implemented by bulk kernels
+//
+typedef enum vkLdStTypeE {
+    VKLS_UNIT,              // unit-stride
+    VKLS_STRIDED,           // strided
+    VKLS_INDEXED,           // indexed
+} vkLdStType;
+
+//
+// Indicate whether a bulk kernel can be used for a vector load or store.
+// Kernels access the current data domain directly in little-endian byte order,
+// so are not used if accesses must be recorded, checked by triggers or
+// redirected to another domain
+//
+static Bool useVKLdSt(riscvMorphStateP state, iterDescP id) {
+
+    riscvP riscv = state->riscv;
+
+    return (
+        !state->info.isWhole                                 &&
+        (getVMemBits(state, id)==getEEW(id, 0))              &&
+        !vdOverlapsV0(state, id)                             &&
+        !state->attrs->virtual                               &&
+        !riscv->configInfo.vector_constraint                 &&
+        !riscv->blockState->doLSTrig                         &&
+        !inTransactionMode(riscv)                            &&
+        !riscv->memProfile                                   &&
+        !riscvTraceAccesses(riscv)                           &&
+        !riscv->cache                                        &&
+        (riscvGetCurrentDataEndianMT(riscv)==MEM_ENDIAN_LITTLE)
+    );
+}
+
+//
+// Emit bulk kernel call for vector load or store. The kernel copies active
+// elements (or segments) in pages of plain memory directly, stopping at the
+// first that is misaligned, whose access fails or that is in a page that is
+// not plain memory; any remaining elements are processed by the per-element
+// loop, which follows. A load first probes the pages of the whole range and
+// then copies the prefix that can be loaded in bulk. For a fault-only-first
+// load, a fault found by the probe on any element but the first is suppressed
+// by reducing vl to the index of the failing element, so that the loop is
+// then skipped
+//
+static Bool emitVKLdSt(
+    riscvMorphStateP state,
+    iterDescP        id,
+    vkLdStType       type,
+    Bool             isStore
+) {
+    if(useVKLdSt(state, id)) {
+
+        riscvP       riscv    = state->riscv;
+        unpackedReg  rs1      = unpackRX(state, 1);
+        Uns32        raBits   = rs1.bits;
+        Uns64        addrMask = getAddressMask(raBits);
+        riscvVKFlags flags    = getVKFlags(state, id);
+        Uns32        fieldNum = id->nf+1;
+        Uns32        segment  = RVVK_SEGMENT(fieldNum, getEMUL(id, 0));
+        vmiReg       result   = newTmp(state);
+        vmiReg       base     = newTmp(state);
+        vmiReg       stride   = newTmp(state);
+
+        // calculated addresses are also truncated to current XLEN
+        addrMask &= getAddressMask(riscvGetXlenMode(riscv));
+
+        if(isStore) {
+            flags |= RVVK_STORE;
+        }
+
+        vmimtMoveExtendRR(64, base, raBits, rs1.r, False);
+
+        vmimtArgProcessor();
+        emitVKRegArg(state, 0);
+
+        if(type==VKLS_INDEXED) {
+
+            Bool sExtend = riscvVFSupport(riscv, RVVF_SEXT_IOFFSET);
+
+            if(sExtend) {
+                flags |= RVVK_SIGNED;
+            }
+
+            emitVKRegArg(state, 2);
+            vmimtArgUns32(getEEW(id, 0));
+            vmimtArgUns32(getEEW(id, 2));
+            vmimtArgUns32(segment);
+            vmimtArgUns32(flags);
+            emitVKRangeArgs(state, id);
+            vmimtArgReg(64, base);
+            vmimtArgUns64(addrMask);
+            vmimtCallResultAttrs(
+                (vmiCallFn)riscvVKLdStI, 32, result, VMCA_EXCEPTION
+            );
+
+        } else {
+
+            if(type==VKLS_UNIT) {
+
+                // unit-stride segments are contiguous
+                vmimtMoveRC(64, stride, getVMemBits(state, id)/8*fieldNum);
+
+            } else {
+
+                unpackedReg rs2 = unpackRX(state, 2);
+
+                // a load with x0 stride need be performed only once
+                if(!getRIndex(rs2.rA)) {
+                    flags |= RVVK_BCAST;
+                }
+
+                vmimtMoveExtendRR(64, stride, raBits, rs2.r, False);
+            }
+
+            vmimtArgUns32(getEEW(id, 0));
+            vmimtArgUns32(segment);
+            vmimtArgUns32(flags);
+            emitVKRangeArgs(state, id);
+            vmimtArgReg(64, base);
+            vmimtArgReg(64, stride);
+            vmimtArgUns64(addrMask);
+            vmimtCallResultAttrs(
+                (vmiCallFn)riscvVKLdStS, 32, result, VMCA_EXCEPTION
+            );
+        }
+
+        // vstart is the first element not processed by the kernel
+        vmimtMoveExtendRR(64, CSR_REG_MT(vstart), 32, result, False);
+
+        // skip the per-element loop if all elements were processed
+        id->kernelDone = vmimtNewLabel();
+        validateVStart(state, id, vmi_COND_NL, id->kernelDone);
+
+        freeTmp(state);
+        freeTmp(state);
+        freeTmp(state);
+    }
+
+    return False;
+}
+
+//
+// Bulk kernel callback for unit-stride loads. Plain unit-stride loads are
+// implemented more efficiently by the inline per-element loop, so the kernel
+// is used only for fault-only-first loads (which probe the range first) and
+// segment loads
+//
+static RISCV_CHECKV_FN(kernelVLDUCB) {
+
+    if(state->info.isFF || id->nf) {
+        emitVKLdSt(state, id, VKLS_UNIT, False);
+    }
+
+    return False;
+}
+
+//
+// Bulk kernel callback for unit-stride stores (segment stores only, as for
+// loads)
+//
+static RISCV_CHECKV_FN(kernelVSTUCB) {
+
+    if(id->nf) {
+        emitVKLdSt(state, id, VKLS_UNIT, True);
+    }
+
+    return False;
+}
+
+//
+// Bulk kernel callback for strided loads
+//
+static RISCV_CHECKV_FN(kernelVLDSCB) {
+    return emitVKLdSt(state, id, VKLS_STRIDED, False);
+}
+
+//
+// Bulk kernel callback for strided stores
+//
+static RISCV_CHECKV_FN(kernelVSTSCB) {
+    return emitVKLdSt(state, id, VKLS_STRIDED, True);
+}
+
+//
+// Bulk kernel callback for indexed loads
+//
+static RISCV_CHECKV_FN(kernelVLDICB) {
+    return emitVKLdSt(state, id, VKLS_INDEXED, False);
+}
+
+//
+// Bulk kernel callback for indexed stores
+//
+static RISCV_CHECKV_FN(kernelVSTICB) {
+    return emitVKLdSt(state, id, VKLS_INDEXED, True);
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 // VECTOR ATOMIC MEMORY OPERATIONS
@@ -11188,6 +12210,99 @@ static RISCV_MORPHV_FN(emitVIDCB) {
     vmimtMoveRR(id->SEW, id->r[0], CSR_REG_MT(vstart));
 }
 
+//
+// Emit bulk kernel call for VPOPC/VFIRST, returning GPR result
+//
+static void emitVKMaskScalar(
+    riscvMorphStateP state,
+    iterDescP        id,
+    vmiCallFn        kernel
+) {
+    riscvP       riscv = state->riscv;
+    riscvRegDesc rdA   = getRVReg(state, 0);
+
+    vmimtArgProcessor();
+    emitVKRegArg(state, 1);
+    vmimtArgUns32(getVKFlags(state, id));
+    emitVKRangeArgs(state, id);
+    vmimtCallResult(kernel, getRBits(rdA), id->r[0]);
+
+    writeReg(riscv, rdA);
+}
+
+//
+// Bulk kernel callback for VPOPC
+//
+static RISCV_CHECKV_FN(kernelVPOPCCB) {
+    emitVKMaskScalar(state, id, (vmiCallFn)riscvVKCPop);
+    return True;
+}
+
+//
+// Bulk kernel callback for VFIRST
+//
+static RISCV_CHECKV_FN(kernelVFIRSTCB) {
+    emitVKMaskScalar(state, id, (vmiCallFn)riscvVKFirst);
+    return True;
+}
+
+//
+// Emit bulk kernel call for VMSBF/VMSIF/VMSOF
+//
+static void emitVKSetFirst(
+    riscvMorphStateP state,
+    iterDescP        id,
+    riscvVKFirstOp   type
+) {
+    vmimtArgProcessor();
+    emitVKRegArg(state, 0);
+    emitVKRegArg(state, 1);
+    vmimtArgUns32(type);
+    vmimtArgUns32(getVKFlags(state, id));
+    emitVKRangeArgs(state, id);
+    vmimtCall((vmiCallFn)riscvVKSetFirst);
+}
+
+//
+// Bulk kernel callback for VMSBF
+//
+static RISCV_CHECKV_FN(kernelVMSBFCB) {
+    emitVKSetFirst(state, id, RVVK_SBF);
+    return True;
+}
+
+//
+// Bulk kernel callback for VMSIF
+//
+static RISCV_CHECKV_FN(kernelVMSIFCB) {
+    emitVKSetFirst(state, id, RVVK_SIF);
+    return True;
+}
+
+//
+// Bulk kernel callback for VMSOF
+//
+static RISCV_CHECKV_FN(kernelVMSOFCB) {
+    emitVKSetFirst(state, id, RVVK_SOF);
+    return True;
+}
+
+//
+// Bulk kernel callback for VIOTA
+//
+static RISCV_CHECKV_FN(kernelVIOTACB) {
+
+    vmimtArgProcessor();
+    emitVKRegArg(state, 0);
+    emitVKRegArg(state, 1);
+    vmimtArgUns32(id->SEW);
+    vmimtArgUns32(getVKFlags(state, id));
+    emitVKRangeArgs(state, id);
+    vmimtCall((vmiCallFn)riscvVKIota);
+
+    return True;
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 // IMPLICIT CARRY OPERATIONS
@@ -11893,32 +13008,156 @@ static RISCV_MORPHV_FN(emitVRSMAccIntCB) {
 // VECTOR INTEGER REDUCTION INSTRUCTIONS
 ////////////////////////////////////////////////////////////////////////////////
 
+//
+// Number of partial sums used by unordered floating point reductions in tree
+// mode
+//
+#define VFRED_TREE_LANES 4
+
+//
+// Indicate whether the current instruction is an unordered floating point sum
+// reduction implemented using partial sums (element i is accumulated in lane
+// i%VFRED_TREE_LANES and the lanes are combined pairwise at the end)
+//
+static Bool useVFRedTree(riscvMorphStateP state) {
+
+    riscvIType type = state->info.type;
+
+    return (
+        state->riscv->vfredTree &&
+        ((type==RV_IT_VFREDUSUM_VS) || (type==RV_IT_VFWREDUSUM_VS))
+    );
+}
+
+//
+// Return the floating point additive identity of the given size in the current
+// rounding mode: -0.0, except when rounding down, when +0.0 + -0.0 is -0.0 and
+// the identity is therefore +0.0
+//
+static Uns64 getVFRedIdentity(riscvP riscv, Uns32 bits) {
+    return (getCurrentRM(riscv)==RV_RM_RDN) ? 0 : (Uns64)1<<(bits-1);
+}
+
 //
 // Initialization callback for reduction operations
 //
 static RISCV_MORPHV_FN(initVRedCB) {
 
-    vmimtMoveRR(getEEW(id, 2), RISCV_VTMP, id->r[2]);
+    vmimtMoveRR(getEEW(id, 2), RISCV_VTMP, id->r[2]);
+
+    // partial sums other than the first start as the additive identity, which
+    // depends on the dynamic rounding mode, so that lanes that accumulate no
+    // element do not change the sign of a zero result
+    if(useVFRedTree(state)) {
+
+        Uns32 i;
+
+        vmimtArgProcessor();
+        vmimtArgUns32(getEEW(id, 0));
+        vmimtCallResult((vmiCallFn)getVFRedIdentity, 64, RISCV_VTMP_I(1));
+
+        for(i=2; i<VFRED_TREE_LANES; i++) {
+            vmimtMoveRR(64, RISCV_VTMP_I(i), RISCV_VTMP_I(1));
+        }
+    }
+}
+
+//
+// Per-element callback for integer reduction operations
+//
+static RISCV_MORPHV_FN(emitVRedBinaryIntCB) {
+
+    vmimtBinopRR(getEEW(id, 0), state->attrs->binop, RISCV_VTMP, id->r[1], 0);
+}
+
+//
+// Combine floating point reduction partial sums pairwise into the first
+//
+static void combineVFRedTree(riscvMorphStateP state, iterDescP id) {
+
+    vmiFType      type = getSEWFType(state, getEEW(id, 0));
+    vmiFBinop     op   = state->attrs->fpBinop;
+    vmiFPConfigCP ctrl = getFPControl(state);
+
+    if(emitSetOperationRM(state)) {
+
+        vmiReg flags = riscvGetFPFlagsMT(state->riscv);
+        Uns32  step;
+        Uns32  i;
+
+        for(step=1; step<VFRED_TREE_LANES; step*=2) {
+            for(i=0; i<VFRED_TREE_LANES; i+=step*2) {
+                vmiReg lhs = RISCV_VTMP_I(i);
+                vmiReg rhs = RISCV_VTMP_I(i+step);
+                vmimtFBinopRRR(type, op, lhs, lhs, rhs, flags, ctrl);
+            }
+        }
+    }
+}
+
+//
+// Finalization callback for reduction operations
+//
+static RISCV_MORPHV_FN(endVRedCB) {
+
+    // combine partial sums if the per-element loop accumulated them
+    if(id->redTree) {
+        combineVFRedTree(state, id);
+    }
+
+    // set target register
+    setTail(state->riscv, id->VLEN, id->r[0]);
+
+    // set element 0 of target register
+    vmimtMoveRR(getEEW(id, 0), id->r[0], RISCV_VTMP);
 }
 
 //
-// Per-element callback for integer reduction operations
+// Map integer reduction binop to bulk host kernel operation
 //
-static RISCV_MORPHV_FN(emitVRedBinaryIntCB) {
+static riscvVKRedOp getVKRedOp(vmiBinop binop) {
 
-    vmimtBinopRR(getEEW(id, 0), state->attrs->binop, RISCV_VTMP, id->r[1], 0);
+    switch(binop) {
+        case vmi_AND:  return RVVK_RAND;
+        case vmi_OR:   return RVVK_ROR;
+        case vmi_XOR:  return RVVK_RXOR;
+        case vmi_MIN:  return RVVK_RMINU;
+        case vmi_IMIN: return RVVK_RMIN;
+        case vmi_MAX:  return RVVK_RMAXU;
+        case vmi_IMAX: return RVVK_RMAX;
+        default:       return RVVK_RSUM;
+    }
 }
 
 //
-// Finalization callback for integer reduction operations
+// Bulk kernel callback for integer reduction operations (accumulator prepared
+// by initialization callback and written to vd by finalization callback)
 //
-static RISCV_MORPHV_FN(endVRedCB) {
+static RISCV_CHECKV_FN(kernelVREDINTCB) {
 
-    // set target register
-    setTail(state->riscv, id->VLEN, id->r[0]);
+    riscvSEWMt   SEW   = getEEW(id, 1);
+    riscvVKFlags flags = getVKFlags(state, id);
 
-    // set element 0 of target register
-    vmimtMoveRR(getEEW(id, 0), id->r[0], RISCV_VTMP);
+    // widening reductions accumulate at twice source element width
+    if(getEEW(id, 0)>SEW) {
+
+        flags |= RVVK_WIDEN;
+
+        if(isAnyVArgSigned(state)) {
+            flags |= RVVK_SIGNED;
+        }
+    }
+
+    vmimtArgProcessor();
+    emitVKRegArg(state, 1);
+    vmimtArgUns32(SEW);
+    vmimtArgUns32(getVKRedOp(state->attrs->binop));
+    vmimtArgUns32(flags);
+    emitVKRangeArgs(state, id);
+    vmimtArgReg(64, RISCV_VTMP);
+    vmimtCallResult((vmiCallFn)riscvVKRedInt, 64, RISCV_VTMP);
+
+    return True;
 }
 
 
@@ -12020,6 +13259,169 @@ static RISCV_MORPHV_FN(emitVRMAccFltCB) {
     emitVRMAddFltInt(state, id, 2, 1, 0);
 }
 
+//
+// Indicate whether a floating point bulk kernel can be used for the current
+// operation (host arithmetic is used only for IEEE 754 single and double
+// precision elements)
+//
+static Bool useVKFlt(riscvMorphStateP state, iterDescP id) {
+
+    vmiFType type = getSEWFType(state, id->SEW);
+
+    return (
+        ((type==vmi_FT_32_IEEE_754) || (type==vmi_FT_64_IEEE_754)) &&
+        !vdOverlapsV0(state, id)
+    );
+}
+
+//
+// Emit bulk kernel call for floating point operation with the given operand
+// indices (or VK_NO_ARG). The kernel processes runs of elements until one
+// requires special value handling or a rounding mode other than RNE is active;
+// any remaining elements are processed by the per-element loop, which follows
+//
+static Bool emitVKFlt(
+    riscvMorphStateP state,
+    iterDescP        id,
+    riscvVKFltOp     op,
+    Uns32            arg1Index,
+    Uns32            arg2Index,
+    Uns32            arg3Index
+) {
+    // FS update and rounding mode are established on the path common to the
+    // kernel and per-element loop
+    if(useVKFlt(state, id) && emitSetOperationRM(state)) {
+
+        vmiReg flags      = riscvGetFPFlagsMT(state->riscv);
+        vmiReg result     = newTmp(state);
+        vmiReg scalar     = newTmp(state);
+        Uns32  argIndex[] = {0, arg1Index, arg2Index, arg3Index};
+        Uns32  index[4];
+        Uns32  i;
+
+        // get register indices and any scalar operand
+        for(i=0; i<4; i++) {
+
+            Uns32        argNum = argIndex[i];
+            riscvRegDesc rA     = 0;
+
+            index[i] = RVVK_FSCALAR;
+
+            if(argNum!=VK_NO_ARG) {
+                rA = getRVReg(state, argNum);
+            }
+
+            if(!rA) {
+                // no action
+            } else if(isVReg(rA)) {
+                index[i] = getRIndex(rA);
+            } else {
+                vmimtMoveExtendRR(64, scalar, id->SEW, id->r[argNum], False);
+            }
+        }
+
+        vmimtArgProcessor();
+        vmimtArgUns32(op);
+        vmimtArgUns32(id->SEW);
+        vmimtArgUns32(getVKFlags(state, id));
+        emitVKRangeArgs(state, id);
+        vmimtArgUns32(RVVK_FREGS(index[0], index[1], index[2], index[3]));
+        vmimtArgReg(64, scalar);
+        vmimtCallResult((vmiCallFn)riscvVKFlt, 64, result);
+
+        // vstart is the first element not processed by the kernel
+        vmimtMoveExtendRR(64, CSR_REG_MT(vstart), 32, result, False);
+
+        // accumulate flags raised by processed elements
+        vmimtBinopRC(64, vmi_SHR, result, 32, 0);
+        vmimtBinopRR(8, vmi_OR, flags, result, 0);
+
+        // skip the per-element loop if all elements were processed
+        id->kernelDone = vmimtNewLabel();
+        validateVStart(state, id, vmi_COND_NL, id->kernelDone);
+
+        freeTmp(state);
+        freeTmp(state);
+    }
+
+    return False;
+}
+
+//
+// Map floating point binary operation to bulk kernel operation
+//
+static riscvVKFltOp getVKFltBinop(vmiFBinop binop) {
+
+    switch(binop) {
+        case vmi_FSUB: return RVVK_FSUB;
+        case vmi_FMUL: return RVVK_FMUL;
+        case vmi_FDIV: return RVVK_FDIV;
+        default:       return RVVK_FADD;
+    }
+}
+
+//
+// Bulk kernel callback for floating point binary operations
+//
+static RISCV_CHECKV_FN(kernelVFBINARYCB) {
+
+    riscvVKFltOp op = getVKFltBinop(state->attrs->fpBinop);
+
+    return emitVKFlt(state, id, op, 1, 2, VK_NO_ARG);
+}
+
+//
+// Bulk kernel callback for floating point binary operations with reversed
+// operands
+//
+static RISCV_CHECKV_FN(kernelVFBINARYRCB) {
+
+    riscvVKFltOp op = getVKFltBinop(state->attrs->fpBinop);
+
+    return emitVKFlt(state, id, op, 2, 1, VK_NO_ARG);
+}
+
+//
+// Bulk kernel callback for VFSQRT.V
+//
+static RISCV_CHECKV_FN(kernelVFSQRTCB) {
+    return emitVKFlt(state, id, RVVK_FSQRT, 1, VK_NO_ARG, VK_NO_ARG);
+}
+
+//
+// Map floating point ternary operation to bulk kernel operation
+//
+static riscvVKFltOp getVKFltTernop(vmiFTernop ternop) {
+
+    switch(ternop) {
+        case vmi_FNMADD: return RVVK_FNMADD;
+        case vmi_FMSUB:  return RVVK_FMSUB;
+        case vmi_FNMSUB: return RVVK_FNMSUB;
+        default:         return RVVK_FMADD;
+    }
+}
+
+//
+// Bulk kernel callback for multiply-add instructions overwriting multiplicand
+//
+static RISCV_CHECKV_FN(kernelVFMADDCB) {
+
+    riscvVKFltOp op = getVKFltTernop(state->attrs->fpTernop);
+
+    return emitVKFlt(state, id, op, 0, 1, 2);
+}
+
+//
+// Bulk kernel callback for multiply-add instructions overwriting
+// addend/minuend
+//
+static RISCV_CHECKV_FN(kernelVFMACCCB) {
+
+    riscvVKFltOp op = getVKFltTernop(state->attrs->fpTernop);
+
+    return emitVKFlt(state, id, op, 2, 1, 0);
+}
+
 //
 // Implement fsgnj, fsgnjn or fsgnjx operation
 //
@@ -12116,9 +13518,41 @@ static RISCV_MORPHV_FN(emitVRedBinaryFltCB) {
     vmiFBinop     op   = state->attrs->fpBinop;
     vmiFPConfigCP ctrl = getFPControl(state);
 
-    if(emitSetOperationRM(state)) {
+    if(!emitSetOperationRM(state)) {
+
+        // no action if rounding mode is invalid
+
+    } else if(!useVFRedTree(state)) {
+
         vmiReg flags = riscvGetFPFlagsMT(state->riscv);
         vmimtFBinopRRR(type, op, fd, fs1, fs2, flags, ctrl);
+
+    } else {
+
+        vmiReg    flags = riscvGetFPFlagsMT(state->riscv);
+        vmiReg    lane  = newTmp(state);
+        vmiLabelP done  = vmimtNewLabel();
+        Uns32     i;
+
+        vmimtBinopRRC(32, vmi_AND, lane, CSR_REG_MT(vstart), VFRED_TREE_LANES-1, 0);
+
+        // accumulate the element into partial sum vstart%VFRED_TREE_LANES
+        for(i=0; i<VFRED_TREE_LANES; i++) {
+
+            vmiLabelP next = vmimtNewLabel();
+            vmiReg    acc  = RISCV_VTMP_I(i);
+
+            vmimtCompareRCJumpLabel(32, vmi_COND_NE, lane, i, next);
+            vmimtFBinopRRR(type, op, acc, acc, fs2, flags, ctrl);
+            vmimtUncondJumpLabel(done);
+            vmimtInsertLabel(next);
+        }
+
+        vmimtInsertLabel(done);
+        freeTmp(state);
+
+        // partial sums must be combined by the finalization callback
+        id->redTree = True;
     }
 }
 
@@ -12571,6 +14005,166 @@ static RISCV_MORPHV_FN(emitVCOMPRESSCB) {
     killBaseRegistersAndTemps(state, id);
 }
 
+//
+// Fill temporary with zero-extended 64-bit scalar operand argNum, or with the
+// instruction constant if there is no scalar register
+//
+static void getVKScalarArg(
+    riscvMorphStateP state,
+    iterDescP        id,
+    Uns32            argNum,
+    vmiReg           t
+) {
+    riscvRegDesc rsA = getRVReg(state, argNum);
+
+    if(rsA) {
+        vmimtMoveExtendRR(64, t, getRBits(rsA), id->r[argNum], False);
+    } else {
+        vmimtMoveRC(64, t, state->info.c);
+    }
+}
+
+//
+// Emit leading arguments common to permutation kernels
+//
+static void emitVKPermuteArgs(riscvMorphStateP state, iterDescP id) {
+    vmimtArgProcessor();
+    emitVKRegArg(state, 0);
+    emitVKRegArg(state, 1);
+    vmimtArgUns32(id->SEW);
+    vmimtArgUns32(getVKFlags(state, id));
+    emitVKRangeArgs(state, id);
+}
+
+//
+// Emit bulk kernel call for permutation with 64-bit scalar final argument
+//
+static Bool emitVKPermute(
+    riscvMorphStateP state,
+    iterDescP        id,
+    vmiCallFn        kernel,
+    Bool             useVLMax,
+    vmiReg           scalar
+) {
+    if(vdOverlapsV0(state, id)) {
+        return False;
+    }
+
+    emitVKPermuteArgs(state, id);
+
+    if(useVLMax) {
+        vmimtArgUns32(getVLMAXOp(id));
+    }
+
+    vmimtArgReg(64, scalar);
+    vmimtCall(kernel);
+
+    return True;
+}
+
+//
+// Bulk kernel callback for VSLIDEUP.VX/VSLIDEUP.VI
+//
+static RISCV_CHECKV_FN(kernelVSLIDEUPCB) {
+
+    vmiReg offset = newTmp(state);
+    Bool   result;
+
+    getVKScalarArg(state, id, 2, offset);
+    result = emitVKPermute(state, id, (vmiCallFn)riscvVKSlideUp, False, offset);
+    freeTmp(state);
+
+    return result;
+}
+
+//
+// Bulk kernel callback for VSLIDEDOWN.VX/VSLIDEDOWN.VI
+//
+static RISCV_CHECKV_FN(kernelVSLIDEDOWNCB) {
+
+    vmiReg offset = newTmp(state);
+    Bool   result;
+
+    getVKScalarArg(state, id, 2, offset);
+    result = emitVKPermute(state, id, (vmiCallFn)riscvVKSlideDown, True, offset);
+    freeTmp(state);
+
+    return result;
+}
+
+//
+// Bulk kernel callback for VSLIDE1UP.VX/VFSLIDE1UP.VF (scalar prepared by
+// initialization callback)
+//
+static RISCV_CHECKV_FN(kernelVSLIDE1UPCB) {
+    return emitVKPermute(state, id, (vmiCallFn)riscvVKSlide1Up, False, RISCV_VTMP);
+}
+
+//
+// Bulk kernel callback for VSLIDE1DOWN.VX/VFSLIDE1DOWN.VF (scalar prepared by
+// initialization callback)
+//
+static RISCV_CHECKV_FN(kernelVSLIDE1DOWNCB) {
+    return emitVKPermute(state, id, (vmiCallFn)riscvVKSlide1Down, False, RISCV_VTMP);
+}
+
+//
+// Bulk kernel callback for VRGATHER.VV/VRGATHER.VX/VRGATHER.VI
+//
+static RISCV_CHECKV_FN(kernelVRGATHERCB) {
+
+    Bool result = False;
+
+    if(vdOverlapsV0(state, id)) {
+
+        // use per-element implementation
+
+    } else if(isVReg(getRVReg(state, 2))) {
+
+        // index vector
+        vmimtArgProcessor();
+        emitVKRegArg(state, 0);
+        emitVKRegArg(state, 1);
+        emitVKRegArg(state, 2);
+        vmimtArgUns32(id->SEW);
+        vmimtArgUns32(getEEW(id, 2));
+        vmimtArgUns32(getVKFlags(state, id));
+        emitVKRangeArgs(state, id);
+        vmimtArgUns32(getVLMAXOp(id));
+        vmimtCall((vmiCallFn)riscvVKGatherV);
+
+        result = True;
+
+    } else {
+
+        // scalar or constant index
+        vmiReg index = newTmp(state);
+
+        getVKScalarArg(state, id, 2, index);
+        result = emitVKPermute(state, id, (vmiCallFn)riscvVKGatherX, True, index);
+        freeTmp(state);
+    }
+
+    return result;
+}
+
+//
+// Bulk kernel callback for VCOMPRESS.VM (target tail set by initialization
+// callback)
+//
+static RISCV_CHECKV_FN(kernelVCOMPRESSCB) {
+
+    vmimtArgProcessor();
+    emitVKRegArg(state, 0);
+    emitVKRegArg(state, 1);
+    vmimtArgUns32(getRIndex(state->info.mask));
+    vmimtArgUns32(id->SEW);
+    emitVKRangeArgs(state, id);
+    vmimtCall((vmiCallFn)riscvVKCompress);
+
+    return True;
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 // VECTOR CRYPTOGRAPHIC OPERATIONS
@@ -14895,12 +16489,12 @@ const static riscvMorphAttr dispatchTable[] = {
     [RV_IT_VSETVL_I]         = {morph:emitVSetVLRRC},
 
     // V-extension load/store instructions
-    [RV_IT_VL_I]             = {morph:emitVectorOp, opTCB:emitVLdUCB, checkCB:emitVLdStCheckUCB, initCB:emitVLdStInitCB, vstart0:RVVST_LD_ST, vShape:RVVW_V1I_V1I_V1I_LD},
-    [RV_IT_VLS_I]            = {morph:emitVectorOp, opTCB:emitVLdSCB, checkCB:emitVLdStCheckSCB, initCB:emitVLdStInitCB, vstart0:RVVST_LD_ST, vShape:RVVW_V1I_V1I_V1I_LD},
-    [RV_IT_VLX_I]            = {morph:emitVectorOp, opTCB:emitVLdICB, checkCB:emitVLdStCheckXCB, initCB:emitVLdStInitCB, vstart0:RVVST_LD_ST, vShape:RVVW_V1I_V1I_V1I_LD},
-    [RV_IT_VS_I]             = {morph:emitVectorOp, opTCB:emitVStUCB, checkCB:emitVLdStCheckUCB, initCB:emitVLdStInitCB, vstart0:RVVST_LD_ST, vShape:RVVW_V1I_V1I_V1I_ST},
-    [RV_IT_VSS_I]            = {morph:emitVectorOp, opTCB:emitVStSCB, checkCB:emitVLdStCheckSCB, initCB:emitVLdStInitCB, vstart0:RVVST_LD_ST, vShape:RVVW_V1I_V1I_V1I_ST},
-    [RV_IT_VSX_I]            = {morph:emitVectorOp, opTCB:emitVStICB, checkCB:emitVLdStCheckXCB, initCB:emitVLdStInitCB, vstart0:RVVST_LD_ST, vShape:RVVW_V1I_V1I_V1I_ST},
+    [RV_IT_VL_I]             = {morph:emitVectorOp, opTCB:emitVLdUCB, checkCB:emitVLdStCheckUCB, initCB:emitVLdStInitCB, vstart0:RVVST_LD_ST, vShape:RVVW_V1I_V1I_V1I_LD, kernelCB:kernelVLDUCB},
+    [RV_IT_VLS_I]            = {morph:emitVectorOp, opTCB:emitVLdSCB, checkCB:emitVLdStCheckSCB, initCB:emitVLdStInitCB, vstart0:RVVST_LD_ST, vShape:RVVW_V1I_V1I_V1I_LD, kernelCB:kernelVLDSCB},
+    [RV_IT_VLX_I]            = {morph:emitVectorOp, opTCB:emitVLdICB, checkCB:emitVLdStCheckXCB, initCB:emitVLdStInitCB, vstart0:RVVST_LD_ST, vShape:RVVW_V1I_V1I_V1I_LD, kernelCB:kernelVLDICB},
+    [RV_IT_VS_I]             = {morph:emitVectorOp, opTCB:emitVStUCB, checkCB:emitVLdStCheckUCB, initCB:emitVLdStInitCB, vstart0:RVVST_LD_ST, vShape:RVVW_V1I_V1I_V1I_ST, kernelCB:kernelVSTUCB},
+    [RV_IT_VSS_I]            = {morph:emitVectorOp, opTCB:emitVStSCB, checkCB:emitVLdStCheckSCB, initCB:emitVLdStInitCB, vstart0:RVVST_LD_ST, vShape:RVVW_V1I_V1I_V1I_ST, kernelCB:kernelVSTSCB},
+    [RV_IT_VSX_I]            = {morph:emitVectorOp, opTCB:emitVStICB, checkCB:emitVLdStCheckXCB, initCB:emitVLdStInitCB, vstart0:RVVST_LD_ST, vShape:RVVW_V1I_V1I_V1I_ST, kernelCB:kernelVSTICB},
 
     // V-extension AMO operations (Zvamo)
     [RV_IT_VAMOADD_R]        = {morph:emitVectorOp, opTCB:emitVAMOBinopRRR, checkCB:emitVAMOCheckCB, binop:vmi_ADD,  vstart0:RVVST_LD_ST},
@@ -14942,9 +16536,9 @@ const static riscvMorphAttr dispatchTable[] = {
     [RV_IT_VSLE_VR]          = {morph:emitVectorOp, opTCB:emitVRCmpIntCB,                            cond :vmi_COND_LE,  vShape:RVVW_P1I_V1I_V1I                                },
     [RV_IT_VSGTU_VR]         = {morph:emitVectorOp, opTCB:emitVRCmpIntCB,                            cond :vmi_COND_NBE, vShape:RVVW_P1I_V1I_V1I                                },
     [RV_IT_VSGT_VR]          = {morph:emitVectorOp, opTCB:emitVRCmpIntCB,                            cond :vmi_COND_NLE, vShape:RVVW_P1I_V1I_V1I                                },
-    [RV_IT_VRGATHER_VR]      = {morph:emitVectorOp, opTCB:emitVRRGATHERCB,                                               vShape:RVVW_V1I_V1I_V1I_GR                             },
-    [RV_IT_VSLIDEUP_VR]      = {morph:emitVectorOp, opTCB:emitVRSLIDEUPCB,                                               vShape:RVVW_V1I_V1I_V1I_UP                             },
-    [RV_IT_VSLIDEDOWN_VR]    = {morph:emitVectorOp, opTCB:emitVRSLIDEDOWNCB,                                             vShape:RVVW_V1I_V1I_V1I_DN                             },
+    [RV_IT_VRGATHER_VR]      = {morph:emitVectorOp, opTCB:emitVRRGATHERCB,                                               vShape:RVVW_V1I_V1I_V1I_GR, kernelCB:kernelVRGATHERCB},
+    [RV_IT_VSLIDEUP_VR]      = {morph:emitVectorOp, opTCB:emitVRSLIDEUPCB,                                               vShape:RVVW_V1I_V1I_V1I_UP, kernelCB:kernelVSLIDEUPCB},
+    [RV_IT_VSLIDEDOWN_VR]    = {morph:emitVectorOp, opTCB:emitVRSLIDEDOWNCB,                                             vShape:RVVW_V1I_V1I_V1I_DN, kernelCB:kernelVSLIDEDOWNCB},
     [RV_IT_VSADDU_VR]        = {morph:emitVectorOp, opTCB:emitVRSBinaryCB,                           binop:vmi_ADDUQ,    vShape:RVVW_V1I_V1I_V1I_SAT,  argType:RVVX_UU          },
     [RV_IT_VSADD_VR]         = {morph:emitVectorOp, opTCB:emitVRSBinaryCB,                           binop:vmi_ADDSQ,    vShape:RVVW_V1I_V1I_V1I_SAT,  argType:RVVX_SS          },
     [RV_IT_VSSUBU_VR]        = {morph:emitVectorOp, opTCB:emitVRSBinaryCB,                           binop:vmi_SUBUQ,    vShape:RVVW_V1I_V1I_V1I_SAT,  argType:RVVX_UU          },
@@ -15005,37 +16599,37 @@ const static riscvMorphAttr dispatchTable[] = {
     [RV_IT_VQMACCUS_VR]      = {morph:emitVectorOp, opTCB:emitVRMAccIntCB, checkCB:emitQMACCheckCB,  binop:vmi_ADD,      vShape:RVVW_V4I_V1I_V1I,    argType:RVVX_US},
 
     // V-extension IVV-type instructions
-    [RV_IT_VWREDSUMU_VS]     = {morph:emitVectorOp, opTCB:emitVRedBinaryIntCB, binop:vmi_ADD, vShape:RVVW_S2I_V1I_S2I, argType:RVVX_UU, vstart0:RVVST_ZERO},
-    [RV_IT_VWREDSUM_VS]      = {morph:emitVectorOp, opTCB:emitVRedBinaryIntCB, binop:vmi_ADD, vShape:RVVW_S2I_V1I_S2I, argType:RVVX_SS, vstart0:RVVST_ZERO},
+    [RV_IT_VWREDSUMU_VS]     = {morph:emitVectorOp, opTCB:emitVRedBinaryIntCB, binop:vmi_ADD, vShape:RVVW_S2I_V1I_S2I, argType:RVVX_UU, vstart0:RVVST_ZERO, kernelCB:kernelVREDINTCB},
+    [RV_IT_VWREDSUM_VS]      = {morph:emitVectorOp, opTCB:emitVRedBinaryIntCB, binop:vmi_ADD, vShape:RVVW_S2I_V1I_S2I, argType:RVVX_SS, vstart0:RVVST_ZERO, kernelCB:kernelVREDINTCB},
     [RV_IT_VDOTU_VV]         = {morph:emitVectorOp, checkCB:emitEDIVCheckCB},
     [RV_IT_VDOT_VV]          = {morph:emitVectorOp, checkCB:emitEDIVCheckCB},
 
     // V-extension FVV/FVF-type common instructions
     [RV_IT_VFMERGE_VR]       = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRMERGETCB, opFCB:emitVRMERGEFCB,    vShape:RVVW_V1F_V1F_V1F},
-    [RV_IT_VFADD_VR]         = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRBinaryFltCB,  fpBinop: vmi_FADD,   vShape:RVVW_V1F_V1F_V1F},
-    [RV_IT_VFSUB_VR]         = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRBinaryFltCB,  fpBinop: vmi_FSUB,   vShape:RVVW_V1F_V1F_V1F},
-    [RV_IT_VFRSUB_VR]        = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRBinaryFltRCB, fpBinop: vmi_FSUB,   vShape:RVVW_V1F_V1F_V1F},
-    [RV_IT_VFMUL_VR]         = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRBinaryFltCB,  fpBinop: vmi_FMUL,   vShape:RVVW_V1F_V1F_V1F},
-    [RV_IT_VFDIV_VR]         = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRBinaryFltCB,  fpBinop: vmi_FDIV,   vShape:RVVW_V1F_V1F_V1F},
-    [RV_IT_VFRDIV_VR]        = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRBinaryFltRCB, fpBinop: vmi_FDIV,   vShape:RVVW_V1F_V1F_V1F},
+    [RV_IT_VFADD_VR]         = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRBinaryFltCB,  fpBinop: vmi_FADD,   vShape:RVVW_V1F_V1F_V1F, kernelCB:kernelVFBINARYCB},
+    [RV_IT_VFSUB_VR]         = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRBinaryFltCB,  fpBinop: vmi_FSUB,   vShape:RVVW_V1F_V1F_V1F, kernelCB:kernelVFBINARYCB},
+    [RV_IT_VFRSUB_VR]        = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRBinaryFltRCB, fpBinop: vmi_FSUB,   vShape:RVVW_V1F_V1F_V1F, kernelCB:kernelVFBINARYRCB},
+    [RV_IT_VFMUL_VR]         = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRBinaryFltCB,  fpBinop: vmi_FMUL,   vShape:RVVW_V1F_V1F_V1F, kernelCB:kernelVFBINARYCB},
+    [RV_IT_VFDIV_VR]         = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRBinaryFltCB,  fpBinop: vmi_FDIV,   vShape:RVVW_V1F_V1F_V1F, kernelCB:kernelVFBINARYCB},
+    [RV_IT_VFRDIV_VR]        = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRBinaryFltRCB, fpBinop: vmi_FDIV,   vShape:RVVW_V1F_V1F_V1F, kernelCB:kernelVFBINARYRCB},
     [RV_IT_VFWADD_VR]        = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRBinaryFltCB,  fpBinop: vmi_FADD,   vShape:RVVW_V2F_V1F_V1F},
     [RV_IT_VFWSUB_VR]        = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRBinaryFltCB,  fpBinop: vmi_FSUB,   vShape:RVVW_V2F_V1F_V1F},
     [RV_IT_VFWADD_WR]        = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRBinaryFltCB,  fpBinop: vmi_FADD,   vShape:RVVW_V2F_V2F_V1F},
     [RV_IT_VFWSUB_WR]        = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRBinaryFltCB,  fpBinop: vmi_FSUB,   vShape:RVVW_V2F_V2F_V1F},
     [RV_IT_VFWMUL_VR]        = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRBinaryFltCB,  fpBinop: vmi_FMUL,   vShape:RVVW_V2F_V1F_V1F},
-    [RV_IT_VFMADD_VR]        = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRMAddFltCB,    fpTernop:vmi_FMADD,  vShape:RVVW_V1F_V1F_V1F},
-    [RV_IT_VFNMADD_VR]       = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRMAddFltCB,    fpTernop:vmi_FNMADD, vShape:RVVW_V1F_V1F_V1F},
-    [RV_IT_VFMSUB_VR]        = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRMAddFltCB,    fpTernop:vmi_FMSUB,  vShape:RVVW_V1F_V1F_V1F},
-    [RV_IT_VFNMSUB_VR]       = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRMAddFltCB,    fpTernop:vmi_FNMSUB, vShape:RVVW_V1F_V1F_V1F},
-    [RV_IT_VFMACC_VR]        = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRMAccFltCB,    fpTernop:vmi_FMADD,  vShape:RVVW_V1F_V1F_V1F},
-    [RV_IT_VFNMACC_VR]       = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRMAccFltCB,    fpTernop:vmi_FNMADD, vShape:RVVW_V1F_V1F_V1F},
-    [RV_IT_VFMSAC_VR]        = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRMAccFltCB,    fpTernop:vmi_FMSUB,  vShape:RVVW_V1F_V1F_V1F},
-    [RV_IT_VFNMSAC_VR]       = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRMAccFltCB,    fpTernop:vmi_FNMSUB, vShape:RVVW_V1F_V1F_V1F},
+    [RV_IT_VFMADD_VR]        = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRMAddFltCB,    fpTernop:vmi_FMADD,  vShape:RVVW_V1F_V1F_V1F, kernelCB:kernelVFMADDCB},
+    [RV_IT_VFNMADD_VR]       = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRMAddFltCB,    fpTernop:vmi_FNMADD, vShape:RVVW_V1F_V1F_V1F, kernelCB:kernelVFMADDCB},
+    [RV_IT_VFMSUB_VR]        = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRMAddFltCB,    fpTernop:vmi_FMSUB,  vShape:RVVW_V1F_V1F_V1F, kernelCB:kernelVFMADDCB},
+    [RV_IT_VFNMSUB_VR]       = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRMAddFltCB,    fpTernop:vmi_FNMSUB, vShape:RVVW_V1F_V1F_V1F, kernelCB:kernelVFMADDCB},
+    [RV_IT_VFMACC_VR]        = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRMAccFltCB,    fpTernop:vmi_FMADD,  vShape:RVVW_V1F_V1F_V1F, kernelCB:kernelVFMACCCB},
+    [RV_IT_VFNMACC_VR]       = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRMAccFltCB,    fpTernop:vmi_FNMADD, vShape:RVVW_V1F_V1F_V1F, kernelCB:kernelVFMACCCB},
+    [RV_IT_VFMSAC_VR]        = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRMAccFltCB,    fpTernop:vmi_FMSUB,  vShape:RVVW_V1F_V1F_V1F, kernelCB:kernelVFMACCCB},
+    [RV_IT_VFNMSAC_VR]       = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRMAccFltCB,    fpTernop:vmi_FNMSUB, vShape:RVVW_V1F_V1F_V1F, kernelCB:kernelVFMACCCB},
     [RV_IT_VFWMACC_VR]       = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRMAccFltCB,    fpTernop:vmi_FMADD,  vShape:RVVW_V2F_V1F_V1F},
     [RV_IT_VFWNMACC_VR]      = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRMAccFltCB,    fpTernop:vmi_FNMADD, vShape:RVVW_V2F_V1F_V1F},
     [RV_IT_VFWMSAC_VR]       = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRMAccFltCB,    fpTernop:vmi_FMSUB,  vShape:RVVW_V2F_V1F_V1F},
     [RV_IT_VFWNMSAC_VR]      = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRMAccFltCB,    fpTernop:vmi_FNMSUB, vShape:RVVW_V2F_V1F_V1F},
-    [RV_IT_VFSQRT_V]         = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRUnaryFltCB,   fpUnop:  vmi_FSQRT,  vShape:RVVW_V1F_V1F_V1F},
+    [RV_IT_VFSQRT_V]         = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, opTCB:emitVRUnaryFltCB,   fpUnop:  vmi_FSQRT,  vShape:RVVW_V1F_V1F_V1F, kernelCB:kernelVFSQRTCB},
     [RV_IT_VFRSQRTE7_V]      = {fpConfig:RVFP_FRSRE7, morph:emitVectorOp, opTCB:emitVRUnaryFltCB,   fpUnop:  vmi_FUNUD,  vShape:RVVW_V1F_V1F_V1F},
     [RV_IT_VFRECE7_V]        = {fpConfig:RVFP_FRECE7, morph:emitVectorOp, opTCB:emitVRUnaryFltCB,   fpUnop:  vmi_FUNUD,  vShape:RVVW_V1F_V1F_V1F},
     [RV_IT_VFMIN_VR]         = {fpConfig:RVFP_FMIN,   morph:emitVectorOp, opTCB:emitVRBinaryFltCB,  fpBinop: vmi_FMIN,   vShape:RVVW_V1F_V1F_V1F},
@@ -15077,23 +16671,23 @@ const static riscvMorphAttr dispatchTable[] = {
     [RV_IT_VFDOT_VV]         = {fpConfig:RVFP_NORMAL, morph:emitVectorOp, checkCB:emitEDIVCheckCB,                     vShape:RVVW_V1F_V1F_V1F                    },
 
     // V-extension MVV-type instructions
-    [RV_IT_VREDSUM_VS]       = {morph:emitVectorOp, opTCB:emitVRedBinaryIntCB,                         binop:vmi_ADD,  vShape:RVVW_S1I_V1I_S1I,      vstart0:RVVST_ZERO},
-    [RV_IT_VREDAND_VS]       = {morph:emitVectorOp, opTCB:emitVRedBinaryIntCB,                         binop:vmi_AND,  vShape:RVVW_S1I_V1I_S1I,      vstart0:RVVST_ZERO},
-    [RV_IT_VREDOR_VS]        = {morph:emitVectorOp, opTCB:emitVRedBinaryIntCB,                         binop:vmi_OR,   vShape:RVVW_S1I_V1I_S1I,      vstart0:RVVST_ZERO},
-    [RV_IT_VREDXOR_VS]       = {morph:emitVectorOp, opTCB:emitVRedBinaryIntCB,                         binop:vmi_XOR,  vShape:RVVW_S1I_V1I_S1I,      vstart0:RVVST_ZERO},
-    [RV_IT_VREDMINU_VS]      = {morph:emitVectorOp, opTCB:emitVRedBinaryIntCB,                         binop:vmi_MIN,  vShape:RVVW_S1I_V1I_S1I,      vstart0:RVVST_ZERO},
-    [RV_IT_VREDMIN_VS]       = {morph:emitVectorOp, opTCB:emitVRedBinaryIntCB,                         binop:vmi_IMIN, vShape:RVVW_S1I_V1I_S1I,      vstart0:RVVST_ZERO},
-    [RV_IT_VREDMAXU_VS]      = {morph:emitVectorOp, opTCB:emitVRedBinaryIntCB,                         binop:vmi_MAX,  vShape:RVVW_S1I_V1I_S1I,      vstart0:RVVST_ZERO},
-    [RV_IT_VREDMAX_VS]       = {morph:emitVectorOp, opTCB:emitVRedBinaryIntCB,                         binop:vmi_IMAX, vShape:RVVW_S1I_V1I_S1I,      vstart0:RVVST_ZERO},
+    [RV_IT_VREDSUM_VS]       = {morph:emitVectorOp, opTCB:emitVRedBinaryIntCB,                         binop:vmi_ADD,  vShape:RVVW_S1I_V1I_S1I,      vstart0:RVVST_ZERO, kernelCB:kernelVREDINTCB},
+    [RV_IT_VREDAND_VS]       = {morph:emitVectorOp, opTCB:emitVRedBinaryIntCB,                         binop:vmi_AND,  vShape:RVVW_S1I_V1I_S1I,      vstart0:RVVST_ZERO, kernelCB:kernelVREDINTCB},
+    [RV_IT_VREDOR_VS]        = {morph:emitVectorOp, opTCB:emitVRedBinaryIntCB,                         binop:vmi_OR,   vShape:RVVW_S1I_V1I_S1I,      vstart0:RVVST_ZERO, kernelCB:kernelVREDINTCB},
+    [RV_IT_VREDXOR_VS]       = {morph:emitVectorOp, opTCB:emitVRedBinaryIntCB,                         binop:vmi_XOR,  vShape:RVVW_S1I_V1I_S1I,      vstart0:RVVST_ZERO, kernelCB:kernelVREDINTCB},
+    [RV_IT_VREDMINU_VS]      = {morph:emitVectorOp, opTCB:emitVRedBinaryIntCB,                         binop:vmi_MIN,  vShape:RVVW_S1I_V1I_S1I,      vstart0:RVVST_ZERO, kernelCB:kernelVREDINTCB},
+    [RV_IT_VREDMIN_VS]       = {morph:emitVectorOp, opTCB:emitVRedBinaryIntCB,                         binop:vmi_IMIN, vShape:RVVW_S1I_V1I_S1I,      vstart0:RVVST_ZERO, kernelCB:kernelVREDINTCB},
+    [RV_IT_VREDMAXU_VS]      = {morph:emitVectorOp, opTCB:emitVRedBinaryIntCB,                         binop:vmi_MAX,  vShape:RVVW_S1I_V1I_S1I,      vstart0:RVVST_ZERO, kernelCB:kernelVREDINTCB},
+    [RV_IT_VREDMAX_VS]       = {morph:emitVectorOp, opTCB:emitVRedBinaryIntCB,                         binop:vmi_IMAX, vShape:RVVW_S1I_V1I_S1I,      vstart0:RVVST_ZERO, kernelCB:kernelVREDINTCB},
     [RV_IT_VEXT_X_V]         = {morph:emitScalarOp, opTCB:emitVEXTXV,                                                  vShape:RVVW_V1I_S1I_V1I,                        },
-    [RV_IT_VPOPC_M]          = {morph:emitVectorOp, opTCB:emitVPOPCCB,         checkCB:initVPOPCCB,                    vShape:RVVW_P1I_P1I_P1I,      vstart0:RVVST_ZERO},
-    [RV_IT_VFIRST_M]         = {morph:emitVectorOp, opTCB:emitVFIRSTCB,        checkCB:initVFIRSTCB,                   vShape:RVVW_P1I_P1I_P1I,      vstart0:RVVST_ZERO},
-    [RV_IT_VMSBF_M]          = {morph:emitVectorOp, opTCB:emitVMSBFCB,         initCB:initVMSFCB,                      vShape:RVVW_P1I_P1I_P1I_VMSF, vstart0:RVVST_ZERO},
-    [RV_IT_VMSOF_M]          = {morph:emitVectorOp, opTCB:emitVMSOFCB,         initCB:initVMSFCB,                      vShape:RVVW_P1I_P1I_P1I_VMSF, vstart0:RVVST_ZERO},
-    [RV_IT_VMSIF_M]          = {morph:emitVectorOp, opTCB:emitVMSIFCB,         initCB:initVMSFCB,                      vShape:RVVW_P1I_P1I_P1I_VMSF, vstart0:RVVST_ZERO},
-    [RV_IT_VIOTA_M]          = {morph:emitVectorOp, opTCB:emitVIOTACB,         initCB:initVIOTACB,                     vShape:RVVW_V1I_P1I_P1I_IOTA, vstart0:RVVST_ZERO},
+    [RV_IT_VPOPC_M]          = {morph:emitVectorOp, opTCB:emitVPOPCCB,         checkCB:initVPOPCCB,                    vShape:RVVW_P1I_P1I_P1I,      vstart0:RVVST_ZERO, kernelCB:kernelVPOPCCB},
+    [RV_IT_VFIRST_M]         = {morph:emitVectorOp, opTCB:emitVFIRSTCB,        checkCB:initVFIRSTCB,                   vShape:RVVW_P1I_P1I_P1I,      vstart0:RVVST_ZERO, kernelCB:kernelVFIRSTCB},
+    [RV_IT_VMSBF_M]          = {morph:emitVectorOp, opTCB:emitVMSBFCB,         initCB:initVMSFCB,                      vShape:RVVW_P1I_P1I_P1I_VMSF, vstart0:RVVST_ZERO, kernelCB:kernelVMSBFCB},
+    [RV_IT_VMSOF_M]          = {morph:emitVectorOp, opTCB:emitVMSOFCB,         initCB:initVMSFCB,                      vShape:RVVW_P1I_P1I_P1I_VMSF, vstart0:RVVST_ZERO, kernelCB:kernelVMSOFCB},
+    [RV_IT_VMSIF_M]          = {morph:emitVectorOp, opTCB:emitVMSIFCB,         initCB:initVMSFCB,                      vShape:RVVW_P1I_P1I_P1I_VMSF, vstart0:RVVST_ZERO, kernelCB:kernelVMSIFCB},
+    [RV_IT_VIOTA_M]          = {morph:emitVectorOp, opTCB:emitVIOTACB,         initCB:initVIOTACB,                     vShape:RVVW_V1I_P1I_P1I_IOTA, vstart0:RVVST_ZERO, kernelCB:kernelVIOTACB},
     [RV_IT_VID_V]            = {morph:emitVectorOp, opTCB:emitVIDCB,                                                   vShape:RVVW_V1I_P1I_P1I_ID,                     },
-    [RV_IT_VCOMPRESS_VM]     = {morph:emitVectorOp, opTCB:emitVCOMPRESSCB,     initCB:initVCOMPRESSCB,                 vShape:RVVW_V1I_V1I_V1I_CMP,  vstart0:RVVST_ZERO, implicitTZ:1},
+    [RV_IT_VCOMPRESS_VM]     = {morph:emitVectorOp, opTCB:emitVCOMPRESSCB,     initCB:initVCOMPRESSCB,                 vShape:RVVW_V1I_V1I_V1I_CMP,  vstart0:RVVST_ZERO, implicitTZ:1, kernelCB:kernelVCOMPRESSCB},
     [RV_IT_VMAND_MM]         = {morph:emitVectorOp, opTCB:emitMBinaryCB,                               binop:vmi_AND,  vShape:RVVW_P1I_P1I_P1I                         },
     [RV_IT_VMANDNOT_MM]      = {morph:emitVectorOp, opTCB:emitMBinaryCB,                               binop:vmi_ANDN, vShape:RVVW_P1I_P1I_P1I                         },
     [RV_IT_VMOR_MM]          = {morph:emitVectorOp, opTCB:emitMBinaryCB,                               binop:vmi_OR,   vShape:RVVW_P1I_P1I_P1I                         },
@@ -15116,9 +16710,9 @@ const static riscvMorphAttr dispatchTable[] = {
     [RV_IT_VAND_VI]          = {morph:emitVectorOp, opTCB:emitVIBinaryIntCB,  binop:vmi_AND                                                                             },
     [RV_IT_VOR_VI]           = {morph:emitVectorOp, opTCB:emitVIBinaryIntCB,  binop:vmi_OR                                                                              },
     [RV_IT_VXOR_VI]          = {morph:emitVectorOp, opTCB:emitVIBinaryIntCB,  binop:vmi_XOR                                                                             },
-    [RV_IT_VRGATHER_VI]      = {morph:emitVectorOp, opTCB:emitVIRGATHERCB,    initCB:initVIRGATHERCB,             vShape:RVVW_V1I_V1I_V1I_GR                            },
-    [RV_IT_VSLIDEUP_VI]      = {morph:emitVectorOp, opTCB:emitVISLIDEUPCB,                                        vShape:RVVW_V1I_V1I_V1I_UP                            },
-    [RV_IT_VSLIDEDOWN_VI]    = {morph:emitVectorOp, opTCB:emitVISLIDEDOWNCB,                                      vShape:RVVW_V1I_V1I_V1I_DN                            },
+    [RV_IT_VRGATHER_VI]      = {morph:emitVectorOp, opTCB:emitVIRGATHERCB,    initCB:initVIRGATHERCB,             vShape:RVVW_V1I_V1I_V1I_GR, kernelCB:kernelVRGATHERCB},
+    [RV_IT_VSLIDEUP_VI]      = {morph:emitVectorOp, opTCB:emitVISLIDEUPCB,                                        vShape:RVVW_V1I_V1I_V1I_UP, kernelCB:kernelVSLIDEUPCB},
+    [RV_IT_VSLIDEDOWN_VI]    = {morph:emitVectorOp, opTCB:emitVISLIDEDOWNCB,                                      vShape:RVVW_V1I_V1I_V1I_DN, kernelCB:kernelVSLIDEDOWNCB},
     [RV_IT_VADC_VI]          = {morph:emitVectorOp, opTCB:emitVIAdcIntCB,     binop:vmi_ADC,                      vShape:RVVW_V1I_V1I_V1I_CIN                           },
     [RV_IT_VMADC_VI]         = {morph:emitVectorOp, opTCB:emitVIAdcIntCB,     binop:vmi_ADC,                      vShape:RVVW_P1I_V1I_V1I_CIN                           },
     [RV_IT_VSEQ_VI]          = {morph:emitVectorOp, opTCB:emitVICmpIntCB,     cond :vmi_COND_EQ,                  vShape:RVVW_P1I_V1I_V1I                               },
@@ -15145,13 +16739,13 @@ const static riscvMorphAttr dispatchTable[] = {
 
     // V-extension FVF-type instructions
     [RV_IT_VFMV_S_F]         = {morph:emitScalarOp, opTCB:emitVFMVSF,                                            vShape:RVVW_S1F_V1I_V1I},
-    [RV_IT_VFSLIDE1UP_VF]    = {morph:emitVectorOp, opTCB:emitVRSLIDE1UPCB,   initCB:initVFSLIDE1CB,             vShape:RVVW_V1F_V1F_V1I_UP},
-    [RV_IT_VFSLIDE1DOWN_VF]  = {morph:emitVectorOp, opTCB:emitVRSLIDE1DOWNCB, initCB:initVFSLIDE1CB,             vShape:RVVW_V1F_V1F_V1I_DN},
+    [RV_IT_VFSLIDE1UP_VF]    = {morph:emitVectorOp, opTCB:emitVRSLIDE1UPCB,   initCB:initVFSLIDE1CB,             vShape:RVVW_V1F_V1F_V1I_UP, kernelCB:kernelVSLIDE1UPCB},
+    [RV_IT_VFSLIDE1DOWN_VF]  = {morph:emitVectorOp, opTCB:emitVRSLIDE1DOWNCB, initCB:initVFSLIDE1CB,             vShape:RVVW_V1F_V1F_V1I_DN, kernelCB:kernelVSLIDE1DOWNCB},
 
     // V-extension MVX-type instructions
     [RV_IT_VMV_S_X]          = {morph:emitScalarOp, opTCB:emitVMVSX,                                             vShape:RVVW_S1I_V1I_V1I},
-    [RV_IT_VSLIDE1UP_VX]     = {morph:emitVectorOp, opTCB:emitVRSLIDE1UPCB,   initCB:initVXSLIDE1CB,             vShape:RVVW_V1I_V1I_V1I_UP},
-    [RV_IT_VSLIDE1DOWN_VX]   = {morph:emitVectorOp, opTCB:emitVRSLIDE1DOWNCB, initCB:initVXSLIDE1CB,             vShape:RVVW_V1I_V1I_V1I_DN},
+    [RV_IT_VSLIDE1UP_VX]     = {morph:emitVectorOp, opTCB:emitVRSLIDE1UPCB,   initCB:initVXSLIDE1CB,             vShape:RVVW_V1I_V1I_V1I_UP, kernelCB:kernelVSLIDE1UPCB},
+    [RV_IT_VSLIDE1DOWN_VX]   = {morph:emitVectorOp, opTCB:emitVRSLIDE1DOWNCB, initCB:initVXSLIDE1CB,             vShape:RVVW_V1I_V1I_V1I_DN, kernelCB:kernelVSLIDE1DOWNCB},
     [RV_IT_VZEXT_V]          = {morph:emitVectorOp, opTCB:emitVRUnaryIntCB,   unop :vmi_MOV,                     vShape:RVVW_V1I_V2I_FN, argType:RVVX_UU},
     [RV_IT_VSEXT_V]          = {morph:emitVectorOp, opTCB:emitVRUnaryIntCB,   unop :vmi_MOV,                     vShape:RVVW_V1I_V2I_FN, argType:RVVX_SS},
 
@@ -15368,6 +16962,12 @@ VMI_START_END_BLOCK_FN(riscvStartBlock) {
     thisState->prevState = prevState;
     riscv->blockState    = thisState;
 
+    // record block start in translation statistics
+    riscvProfileBlockStart(riscv, !prevState);
+
+    // instruction fetch buffer contents may be stale
+    riscvInvalidateFetchBuffer(riscv);
+
     // no floating point registers are known to be NaN-boxed initially
     thisState->fpNaNBoxMask[0] = 0;
     thisState->fpNaNBoxMask[1] = 0;
@@ -15376,6 +16976,24 @@ VMI_START_END_BLOCK_FN(riscvStartBlock) {
     thisState->FSDirty = False;
     thisState->VSDirty = False;
 
+    // per-instruction fflags are not known to be clear initially
+    thisState->FFlagsIZero = False;
+
+    // block execution count and cache sampling are emitted with the first
+    // instruction; pending cycle flush is emitted with the first instruction
+    // that may account cycles
+    thisState->countBlock   = True;
+    thisState->flushCycles  = True;
+    thisState->sampleBlock  = True;
+    thisState->profileBlock = 0;
+
+    // no instruction cache line has been fetched initially
+    thisState->fetchLine = -1;
+
+    // no instruction results are available for pair fusion initially
+    thisState->fusePrev.kind = RVFK_NONE;
+    thisState->fuseNext.kind = RVFK_NONE;
+
     // current vector configuration is not known initially
     thisState->SEWMt                 = SEWMT_UNKNOWN;
     thisState->VLMULx8Mt             = VLMULx8MT_UNKNOWN;
@@ -15385,14 +17003,18 @@ VMI_START_END_BLOCK_FN(riscvStartBlock) {
     thisState->VSetTopMt[VTZ_SINGLE] = 0;
     thisState->VSetTopMt[VTZ_GROUP]  = 0;
     thisState->VStartZeroMt          = forceVStart0(riscv);
+    thisState->VTypeSpecMt           = False;
 
-    // inherit any previously-active SEW, VLMUL, VLClass, vta and vma
+    // inherit any previously-active SEW, VLMUL, VLClass, vta and vma (and any
+    // speculated polymorphic key implying them)
     if(prevState) {
-        thisState->SEWMt     = prevState->SEWMt;
-        thisState->VLMULx8Mt = prevState->VLMULx8Mt;
-        thisState->VLClassMt = prevState->VLClassMt;
-        thisState->vtaMt     = prevState->vtaMt;
-        thisState->vmaMt     = prevState->vmaMt;
+        thisState->SEWMt       = prevState->SEWMt;
+        thisState->VLMULx8Mt   = prevState->VLMULx8Mt;
+        thisState->VLClassMt   = prevState->VLClassMt;
+        thisState->vtaMt       = prevState->vtaMt;
+        thisState->vmaMt       = prevState->vmaMt;
+        thisState->VTypeSpecMt = prevState->VTypeSpecMt;
+        thisState->pmKeyMt     = prevState->pmKeyMt;
     }
 }
 
@@ -15412,6 +17034,12 @@ VMI_START_END_BLOCK_FN(riscvEndBlock) {
 
     // restore previously-active block state
     riscv->blockState = thisState->prevState;
+
+    // record block end in translation statistics
+    riscvProfileBlockEnd(riscv, !thisState->prevState);
+
+    // instruction fetch buffer is valid only during translation
+    riscvInvalidateFetchBuffer(riscv);
 }
 
 //
@@ -15425,9 +17053,21 @@ VMI_MORPH_FN(riscvPreMorph) {
     thisState->updateFFlags = False;
     thisState->doLSTrig     = True;
 
-    // clear per-instruction fflags if required
-    if(perInstructionFFlags(riscv)) {
+    // result of previous instruction is available for pair fusion
+    thisState->fusePrev      = thisState->fuseNext;
+    thisState->fuseNext.kind = RVFK_NONE;
+
+    // count block execution for hot block profile if required
+    if(thisState->countBlock) {
+        thisState->countBlock = False;
+        riscvEmitProfileBlock(riscv, thisPC);
+    }
+
+    // clear per-instruction fflags if required (not required if no instruction
+    // has written them since they were last cleared in this block)
+    if(perInstructionFFlags(riscv) && !thisState->FFlagsIZero) {
         vmimtMoveRC(8, RISCV_FP_FLAGS_I, 0);
+        thisState->FFlagsIZero = True;
     }
 
     // call derived model preMorph functions if required
@@ -15445,7 +17085,12 @@ VMI_MORPH_FN(riscvPostMorph) {
     riscvP           riscv     = (riscvP)processor;
     riscvBlockStateP thisState = blockState;
 
-    // accumulate sticky fflags if required
+    // accumulate sticky fflags if required (NOTE: this is not deferred to the
+    // end of the block because fflags_i holds the flags of this instruction
+    // only and is cleared before the next one, so a deferred merge would need
+    // the same per-instruction OR into a second accumulator register, and that
+    // register would also have to be merged on every exception and fflags or
+    // fcsr access)
     if(thisState->updateFFlags) {
         vmimtBinopRR(8, vmi_OR, RISCV_FP_FLAGS, RISCV_FP_FLAGS_I, 0);
     }
@@ -15485,6 +17130,69 @@ static Bool doExecuteTrigger(riscvP riscv, Uns32 instruction, Uns32 bytes) {
     return False;
 }
 
+//
+// Return the latency class of an instruction for approximate timing
+//
+static riscvLatencyClass getLatencyClass(riscvMorphStateP state) {
+
+    riscvMorphAttrCP attrs   = state->attrs;
+    vmiBinop         binop   = attrs->binop;
+    Bool             isStore = (attrs->morph==emitStore) || (attrs->morph==emitSC);
+    riscvIType       type    = state->info.type;
+
+    if((type==RV_IT_VSETVL_R) || (type==RV_IT_VSETVL_I)) {
+        return RVLC_CSR;
+    } else if(state->info.arch & ISA_V) {
+        return RVLC_VECTOR;
+    } else if(attrs->iClass & OCL_IC_SYSREG) {
+        return RVLC_CSR;
+    } else if(state->info.memBits>0) {
+        return isStore ? RVLC_STORE : RVLC_LOAD;
+    } else if(attrs->iClass & (OCL_IC_DIVIDE|OCL_IC_SQRT)) {
+        return RVLC_FDIV;
+    } else if(state->info.arch & ISA_DFQ) {
+        return RVLC_FP;
+    } else if(
+        (binop==vmi_DIV) || (binop==vmi_IDIV) ||
+        (binop==vmi_REM) || (binop==vmi_IREM)
+    ) {
+        return RVLC_DIV;
+    } else if(
+        (binop==vmi_MUL)    || (binop==vmi_IMUL) ||
+        (binop==vmi_IMULSU) || (binop==vmi_PMUL)
+    ) {
+        return RVLC_MUL;
+    } else {
+        return RVLC_INT;
+    }
+}
+
+//
+// Return the number of registers by which the latency of a vector instruction
+// is scaled when this is fixed by the instruction (whole-register moves, loads
+// and stores and mask loads and stores), or 0 if it is given by LMUL
+//
+static Uns32 getLatencyVRegs(riscvMorphStateP state) {
+
+    if(state->info.isWhole) {
+        return state->info.nf+1;
+    } else if(state->info.eew==1) {
+        return 1;
+    } else {
+        return 0;
+    }
+}
+
+//
+// Insert optional call to record instruction in binary trace
+//
+static Bool doBinaryTrace(riscvP riscv, Uns64 instruction, Uns32 bytes) {
+
+    riscvEmitTraceInstruction(riscv, instruction, bytes, getPMKeyMt(riscv));
+
+    return False;
+}
+
 //
 // Instruction Morpher
 //
@@ -15496,14 +17204,19 @@ VMI_MORPH_FN(riscvMorph) {
     // get instruction and instruction type
     riscvDecode(riscv, thisPC, &state.info);
 
+    // record instruction in translation statistics
+    riscvProfileTranslate(riscv, &state.info);
+
     // fill JIT translation state
     state.attrs       = &dispatchTable[state.info.type];
     state.riscv       = riscv;
     state.inDelaySlot = inDelaySlot;
     state.tmpIndex    = 0;
 
-    // clear mask of X registers targeted by this instruction
+    // clear masks of X, F and V registers targeted by this instruction
     riscv->writtenXMask = 0;
+    riscv->writtenFMask = 0;
+    riscv->writtenVMask = 0;
 
     // handle fixed point vector instructions that have an implicit dependency
     // on mstatus.FS
@@ -15521,6 +17234,10 @@ VMI_MORPH_FN(riscvMorph) {
 
         // no action if in disassembly mode
 
+    } else if(doBinaryTrace(riscv, state.info.instruction, state.info.bytes)) {
+
+        // binary trace record precedes all other actions
+
     } else if(doExecuteTrigger(riscv, state.info.instruction, state.info.bytes)) {
 
         // execute trigger precedes Illegal Instruction check
@@ -15559,6 +17276,17 @@ VMI_MORPH_FN(riscvMorph) {
         // give information about instruction class
         vmimtInstructionClassAdd(state.attrs->iClass);
 
+        // count instruction for instruction mix profile if required
+        riscvEmitProfileInstruction(riscv, &state.info);
+
+        // account instruction latency for approximate timing if required
+        riscvEmitTimingInstruction(
+            riscv, getLatencyClass(&state), getLatencyVRegs(&state)
+        );
+
+        // simulate instruction cache access if required
+        riscvEmitCacheFetch(riscv, thisPC, state.info.bytes);
+
         // translate the instruction with Zfhmin/Zfbfmin/Zvfbfwma context
         riscv->blockState->ZfhminOK   = state.attrs->ZfhminOK;
         riscv->blockState->ZfbfminOK  = state.attrs->ZfbfminOK;
@@ -15576,6 +17304,9 @@ VMI_MORPH_FN(riscvMorph) {
             SRCREF_ARGS(riscv, thisPC)
         );
     }
+
+    // record X registers written by instruction in binary trace if required
+    riscvEmitTraceInstructionEnd(riscv);
 }
 
 //
@@ -15591,10 +17322,19 @@ void riscvMorphExternal(
     // indicate instruction is implemented here
     *opaque = True;
 
+    // clear masks of X, F and V registers targeted by this instruction
+    riscv->writtenXMask = 0;
+    riscv->writtenFMask = 0;
+    riscv->writtenVMask = 0;
+
     if(RISCV_DISASSEMBLE(riscv)) {
 
         // no action if in disassembly mode
 
+    } else if(doBinaryTrace(riscv, state->info.instruction, state->info.bytes)) {
+
+        // binary trace record precedes all other actions
+
     } else if(doExecuteTrigger(riscv, state->info.instruction, state->info.bytes)) {
 
         // execute trigger precedes Illegal Instruction check
@@ -15622,6 +17362,9 @@ void riscvMorphExternal(
             SRCREF_ARGS(riscv, getPC(riscv))
         );
     }
+
+    // record X registers written by instruction in binary trace if required
+    riscvEmitTraceInstructionEnd(riscv);
 }
 
 //
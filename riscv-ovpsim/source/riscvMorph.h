@@ -293,6 +293,11 @@ void riscvEmitTrapVTI(riscvP riscv);
 //
 void riscvConfigureVector(riscvP riscv);
 
+//
+// Allocate vector registers for a hart if they are still shared zero values
+//
+void riscvAllocVector(riscvP riscv);
+
 //
 // Free vector extension data structures
 //
@@ -308,6 +313,11 @@ void riscvWVStart(riscvMorphStateP state, Bool useRS1);
 //
 riscvSEWMt riscvGetSEWMt(riscvP riscv);
 
+//
+// Get effective vector length multiplier
+//
+riscvVLMULx8Mt riscvGetVLMULx8Mt(riscvP riscv);
+
 //
 // Return maximum vector length for the given vector type settings
 //
@@ -2069,6 +2069,23 @@ static riscvParameter parameters[] = {
     {  RVPV_D,       0,         default_ABI_d,                VMI_BOOL_GROUP_PARAM_SPEC  (riscvParamValues, ABI_d,                   False,                     RV_GROUP(ARTIF), "Specify whether D registers are used for parameters (ABI SemiHosting)")},
     {  RVPV_ALL,     0,         0,                            VMI_BOOL_GROUP_PARAM_SPEC  (riscvParamValues, verbose,                 False,                     RV_GROUP(ARTIF), "Specify verbose output messages")},
     {  RVPV_ALL,     0,         0,                            VMI_BOOL_GROUP_PARAM_SPEC  (riscvParamValues, traceVolatile,           False,                     RV_GROUP(ARTIF), "Specify whether volatile registers (e.g. minstret) should be shown in change trace")},
+    {  RVPV_ALL,     0,         0,                            VMI_BOOL_GROUP_PARAM_SPEC  (riscvParamValues, fuse_pairs,              False,                     RV_GROUP(ARTIF), "Specify whether common instruction pairs (e.g. lui+addi, auipc+jalr) should be translated as fused operations")},
+    {  RVPV_ALL,     0,         0,                            VMI_BOOL_GROUP_PARAM_SPEC  (riscvParamValues, instruction_mix,         False,                     RV_GROUP(ARTIF), "Specify whether executed instruction counts by opcode should be collected for each hart and reported at the end of simulation")},
+    {  RVPV_ALL,     0,         0,                            VMI_STRING_GROUP_PARAM_SPEC(riscvParamValues, hot_block_profile,       "",                        RV_GROUP(ARTIF), "Specify a file prefix to which execution counts of each translated block are written at the end of simulation, in collapsed-stack (flame graph) format (one file per hart, suffixed with the hart name)")},
+    {  RVPV_ALL,     0,         0,                            VMI_BOOL_GROUP_PARAM_SPEC  (riscvParamValues, morph_statistics,        False,                     RV_GROUP(ARTIF), "Specify whether code translation statistics (blocks and instructions translated, translation time and dictionary flushes) should be collected for each hart and reported at the end of simulation")},
+    {  RVPV_ALL,     0,         0,                            VMI_STRING_GROUP_PARAM_SPEC(riscvParamValues, binary_trace,            "",                        RV_GROUP(ARTIF), "Specify a file prefix to which a compact binary trace of executed instructions, X register results and exceptions is written (one file per hart, suffixed with the hart name); use command decodeBinaryTrace to print the trace")},
+    {  RVPV_ALL,     0,         0,                            VMI_STRING_GROUP_PARAM_SPEC(riscvParamValues, commit_log,              "",                        RV_GROUP(ARTIF), "Specify a shared memory object name prefix (for example /rvcommit) to which each hart publishes a ring of retired instruction records for lockstep comparison (one object per hart, suffixed with the hart name); while the ring is full the hart waits for an attached consumer to free a slot, and discards records only if no consumer is attached")},
+    {  RVPV_ALL,     0,         0,                            VMI_BOOL_GROUP_PARAM_SPEC  (riscvParamValues, binary_trace_memory,     False,                     RV_GROUP(ARTIF), "Specify whether the binary trace (see parameter binary_trace) should also record the virtual address and size of every load and store, including vector element accesses")},
+    {  RVPV_ALL,     0,         0,                            VMI_BOOL_GROUP_PARAM_SPEC  (riscvParamValues, memory_profile,          False,                     RV_GROUP(ARTIF), "Specify whether a memory access profile (read, write and execute counts and accessed cache lines per virtual page, and line changes per load/store site) should be collected for each hart and reported at the end of simulation")},
+    {  RVPV_ALL,     0,         0,                            VMI_STRING_GROUP_PARAM_SPEC(riscvParamValues, bbv_file,                "",                        RV_GROUP(ARTIF), "Specify a file prefix to which basic block vectors are written in SimPoint .bb format (one file per hart, suffixed with the hart name; one line per interval of bbv_interval instructions)")},
+    {  RVPV_ALL,     0,         0,                            VMI_UNS64_GROUP_PARAM_SPEC (riscvParamValues, bbv_interval,            100000000, 1,          -1,         RV_GROUP(ARTIF), "Specify the number of instructions in each basic block vector interval (see parameter bbv_file)")},
+    {  RVPV_ALL,     0,         0,                            VMI_STRING_GROUP_PARAM_SPEC(riscvParamValues, cycle_latency,           "",                        RV_GROUP(ARTIF), "Specify instruction latencies used to compute an approximate cycle count (mcycle and timers), as comma-separated class=cycles with class one of int, mul, div, fp, fdiv, load, store, csr or vector (vector latency is per register of the active LMUL group, or of the registers accessed by whole-register instructions; vset{i}vl{i} use the csr latency); unspecified classes take one cycle")},
+    {  RVPV_ALL,     0,         0,                            VMI_STRING_GROUP_PARAM_SPEC(riscvParamValues, icache,                  "",                        RV_GROUP(ARTIF), "Specify an instruction cache to simulate, as comma-separated key=value with key one of size (bytes, K or M suffix allowed, default 32K), ways (default 4), line (bytes, default 64), policy (lru, fifo or random, default lru) or miss (penalty cycles added to mcycle, default 0)")},
+    {  RVPV_ALL,     0,         0,                            VMI_STRING_GROUP_PARAM_SPEC(riscvParamValues, dcache,                  "",                        RV_GROUP(ARTIF), "Specify a data cache to simulate (see parameter icache for format)")},
+    {  RVPV_ALL,     0,         0,                            VMI_UNS32_GROUP_PARAM_SPEC (riscvParamValues, cache_sample,            1, 1,          -1,         RV_GROUP(ARTIF), "Specify that only one in every cache_sample executed blocks is simulated by the icache and dcache models (event counts and miss penalties are scaled to estimate totals)")},
+    {  RVPV_ALL,     0,         0,                            VMI_STRING_GROUP_PARAM_SPEC(riscvParamValues, branch_predictor,        "",                        RV_GROUP(ARTIF), "Specify a branch predictor to simulate, as comma-separated key=value with key one of type (bimodal, gshare or tage, default gshare), entries (counter table entries, default 4096), history (gshare history bits, default 12), btb (branch target buffer entries, default 512), ras (return address stack depth, default 16) or penalty (misprediction cycles added to mcycle, default 0)")},
+    {  RVPV_V,       0,         0,                            VMI_BOOL_GROUP_PARAM_SPEC  (riscvParamValues, vector_kernels,          True,                      RV_GROUP(ARTIF), "Specify whether suitable vector instructions should be implemented by host kernels operating on entire registers instead of translated per-element loops (kernels are used only when SLEN=VLEN, VLEN is a multiple of 64 and mask registers hold one bit per element)")},
+    {  RVPV_V,       0,         0,                            VMI_BOOL_GROUP_PARAM_SPEC  (riscvParamValues, vfredusum_tree,          False,                     RV_GROUP(ARTIF), "Specify whether unordered floating point sum reductions (vfredusum.vs and vfwredusum.vs) should accumulate element i in partial sum i%4, combining the four partial sums pairwise at the end, instead of accumulating all elements in order")},
     {  RVPV_MPCORE,  0,         default_numHarts,             VMI_UNS32_GROUP_PARAM_SPEC (riscvParamValues, numHarts,                0, 0,          32,         RV_GROUP(FUND),  "Specify the number of hart contexts in a multiprocessor")},
     {  RVPV_S,       0,         default_updatePTEA,           VMI_BOOL_GROUP_PARAM_SPEC  (riscvParamValues, updatePTEA,              False,                     RV_GROUP(MEM),   "Specify whether hardware update of PTE A bit is supported")},
     {  RVPV_S,       0,         default_updatePTED,           VMI_BOOL_GROUP_PARAM_SPEC  (riscvParamValues, updatePTED,              False,                     RV_GROUP(MEM),   "Specify whether hardware update of PTE D bit is supported")},
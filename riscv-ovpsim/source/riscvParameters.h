@@ -105,6 +105,23 @@ typedef struct riscvParamValuesS {
     VMI_BOOL_PARAM(ABI_d);
     VMI_BOOL_PARAM(verbose);
     VMI_BOOL_PARAM(traceVolatile);
+    VMI_BOOL_PARAM(fuse_pairs);
+    VMI_BOOL_PARAM(instruction_mix);
+    VMI_STRING_PARAM(hot_block_profile);
+    VMI_BOOL_PARAM(morph_statistics);
+    VMI_STRING_PARAM(binary_trace);
+    VMI_STRING_PARAM(commit_log);
+    VMI_BOOL_PARAM(binary_trace_memory);
+    VMI_BOOL_PARAM(memory_profile);
+    VMI_STRING_PARAM(bbv_file);
+    VMI_UNS64_PARAM(bbv_interval);
+    VMI_STRING_PARAM(cycle_latency);
+    VMI_STRING_PARAM(icache);
+    VMI_STRING_PARAM(dcache);
+    VMI_UNS32_PARAM(cache_sample);
+    VMI_STRING_PARAM(branch_predictor);
+    VMI_BOOL_PARAM(vector_kernels);
+    VMI_BOOL_PARAM(vfredusum_tree);
 
     // fundamental configuration
     VMI_ENDIAN_PARAM(endian);
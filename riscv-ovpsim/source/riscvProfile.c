@@ -0,0 +1,1630 @@
+/*
+ * Copyright (c) 2005-2023 Imperas Software Ltd., www.imperas.com
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Standard header files
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Imperas header files
+#include "hostapi/impAlloc.h"
+
+// VMI header files
+#include "vmi/vmiAttrs.h"
+#include "vmi/vmiCommand.h"
+#include "vmi/vmiMessage.h"
+#include "vmi/vmiMt.h"
+#include "vmi/vmiRt.h"
+
+// model header files
+#include "riscvBlockState.h"
+#include "riscvDecodeTypes.h"
+#include "riscvMessage.h"
+#include "riscvMode.h"
+#include "riscvProfile.h"
+#include "riscvStructure.h"
+#include "riscvUtils.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+// TYPES
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// This holds the execution count for one opcode (entries are allocated
+// individually so that the count address is stable for use by JIT code)
+//
+typedef struct riscvMixEntryS {
+    riscvMixEntryP next;        // next entry with the same generic type
+    const char    *opcode;      // opcode name
+    Uns64          count;       // execution count
+} riscvMixEntry;
+
+//
+// This holds the execution count for one translated block, identified by its
+// start address and dictionary mode (entries are allocated individually so
+// that the count addresses are stable for use by JIT code)
+//
+typedef struct riscvBlockEntryS {
+    riscvBlockEntryP next;      // next entry in the same hash bucket
+    Uns64            PC;        // block start address
+    riscvDMode       dMode;     // block dictionary mode
+    Uns32            id;        // block identifier (basic block vector)
+    Uns64            count;     // execution count
+    Uns64            bbvCount;  // instructions executed in current interval
+} riscvBlockEntry;
+
+//
+// Number of hash buckets for block entries (must be a power of two)
+//
+#define BLOCK_HASH_SIZE 4096
+
+//
+// This holds access counts for one 4KB virtual page, including a bitmap of the
+// 64-byte lines accessed within it (exec count entries are allocated at
+// translation time; read and write entries are created on first access)
+//
+typedef struct riscvPageEntryS {
+    riscvPageEntryP next;       // next entry in the same hash bucket
+    Uns64           page;       // virtual page number
+    Uns64           reads;      // read count
+    Uns64           writes;     // write count
+    Uns64           execs;      // executed instruction count
+    Uns64           lines;      // bitmap of 64-byte lines accessed
+} riscvPageEntry;
+
+//
+// This holds access statistics for one load or store site (a translated load
+// or store operation). An access is counted as a line change if it is to a
+// different 64-byte line from the previous access by the same site: sites
+// with a high proportion of line changes are likely to miss in a cache.
+//
+typedef struct riscvAccessSiteS {
+    riscvAccessSiteP next;      // next site in hash bucket
+    Uns64            PC;        // instruction address
+    Uns64            offset;    // constant address offset
+    Uns64            lastLine;  // line accessed by previous access
+    Uns64            accesses;  // access count
+    Uns64            changes;   // line change count
+    Uns64            lastVA;    // address of previous access
+    Uns8             bytes;     // access size
+    Bool             isStore;   // whether a store
+    Bool             is32;      // whether address is 32 bits
+} riscvAccessSite;
+
+//
+// Page and line size used for memory access profile
+//
+#define MEM_PAGE_SHIFT   12
+#define MEM_LINE_SHIFT   6
+
+//
+// Number of hash buckets for page entries (must be a power of two)
+//
+#define PAGE_HASH_SIZE 4096
+
+//
+// Number of hash buckets for access sites (must be a power of two)
+//
+#define SITE_HASH_SIZE 4096
+
+//
+// This holds memory access profile state for a hart
+//
+typedef struct riscvMemProfileS {
+    riscvPageEntryP *pages;     // page entries by hash bucket
+    Uns32            pageNum;   // number of page entries
+    riscvAccessSiteP *sites;    // access sites by hash bucket
+    Uns32            siteNum;   // number of access sites
+} riscvMemProfile;
+
+//
+// This holds translation statistics for a hart
+//
+typedef struct riscvMorphStatsS {
+    Uns64       blocks;                 // blocks translated
+    Uns64       instructions;           // instructions translated
+    Uns64       pmKeyChanges;           // polymorphic key changes
+    clock_t     blockStart;             // host time at outer block start
+    clock_t     morphTime;              // host time spent translating
+    Uns64       flushes[RVFC_LAST];     // dictionary flushes by cause
+    Uns64       bytes[RISCV_DMODE_LAST];// bytes translated by dictionary mode
+    Uns64       types[RV_IT_LAST+1];    // instructions translated by type
+    const char *names[RV_IT_LAST+1];    // example opcode name by type
+} riscvMorphStats;
+
+//
+// This holds profiling state for a hart
+//
+typedef struct riscvProfileS {
+    riscvMixEntryP   *mix;      // instruction mix entries by generic type
+    Uns32             mixNum;   // number of instruction mix entries
+    riscvBlockEntryP *blocks;   // block entries by hash bucket
+    Uns32             blockNum; // number of block entries
+    Bool              hotBlocks;// whether hot block profile enabled
+    Bool              bbv;      // whether basic block vectors enabled
+    FILE             *bbvFile;  // basic block vector file
+    vmiModelTimerP    bbvTimer; // basic block vector interval timer
+    riscvMorphStatsP  stats;    // translation statistics
+    riscvMemProfileP  mem;      // memory access profile
+} riscvProfile;
+
+//
+// Model attributes (used to obtain dictionary names)
+//
+extern const vmiIASAttr modelAttrs;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// INSTRUCTION MIX
+////////////////////////////////////////////////////////////////////////////////
+
+#define INSTRUCTION_MIX_NAME "instructionMix"
+
+//
+// Return the instruction mix entry for the given decoded instruction, creating
+// it if required (instructions are distinguished by opcode name within each
+// generic type, so for example add and addw are counted separately)
+//
+static riscvMixEntryP getMixEntry(riscvProfileP profile, riscvInstrInfoP info) {
+
+    const char     *opcode = info->opcode ? info->opcode : "?";
+    riscvMixEntryP *tailP  = &profile->mix[info->type];
+    riscvMixEntryP  entry;
+
+    // opcode names are static strings, so can be compared by address
+    while((entry=*tailP) && (entry->opcode!=opcode)) {
+        tailP = &entry->next;
+    }
+
+    // create new entry if required
+    if(!entry) {
+        entry = *tailP = STYPE_CALLOC(riscvMixEntry);
+        entry->opcode = opcode;
+        profile->mixNum++;
+    }
+
+    return entry;
+}
+
+//
+// Emit code to count execution of the decoded instruction
+//
+static void emitMixCount(riscvP riscv, riscvInstrInfoP info) {
+
+    riscvMixEntryP entry = getMixEntry(riscv->profile, info);
+    vmiReg         count = vmimtGetExtReg((vmiProcessorP)riscv, &entry->count);
+
+    vmimtBinopRC(64, vmi_ADD, count, 1, 0);
+}
+
+//
+// Compare instruction mix entries by decreasing count, then by opcode name
+//
+static Int32 compareMixEntry(const void *va, const void *vb) {
+
+    riscvMixEntryP a = *(riscvMixEntryP *)va;
+    riscvMixEntryP b = *(riscvMixEntryP *)vb;
+
+    if(a->count>b->count) {
+        return -1;
+    } else if(a->count<b->count) {
+        return 1;
+    } else {
+        return strcmp(a->opcode, b->opcode);
+    }
+}
+
+//
+// Return an array of all instruction mix entries sorted by decreasing count,
+// filling the total execution count
+//
+static riscvMixEntryP *getSortedMix(riscvProfileP profile, Uns64 *totalP) {
+
+    riscvMixEntryP *all   = STYPE_CALLOC_N(riscvMixEntryP, profile->mixNum+1);
+    Uns32           num   = 0;
+    Uns64           total = 0;
+    riscvIType      type;
+    riscvMixEntryP  entry;
+
+    for(type=0; type<RV_IT_LAST; type++) {
+        for(entry=profile->mix[type]; entry; entry=entry->next) {
+            all[num++] = entry;
+            total     += entry->count;
+        }
+    }
+
+    qsort(all, num, sizeof(all[0]), compareMixEntry);
+
+    *totalP = total;
+
+    return all;
+}
+
+//
+// Print instruction mix for a hart
+//
+static void dumpMix(riscvP riscv) {
+
+    Uns64           total;
+    riscvMixEntryP *all = getSortedMix(riscv->profile, &total);
+    riscvMixEntryP  entry;
+    Uns32           i;
+
+    vmiPrintf(
+        "Instruction mix for '%s' ("FMT_Au" instructions):\n",
+        vmirtProcessorName((vmiProcessorP)riscv), total
+    );
+
+    for(i=0; (entry=all[i]) && entry->count; i++) {
+
+        char countString[32];
+
+        sprintf(countString, FMT_Au, entry->count);
+
+        vmiPrintf(
+            "  %-20s %16s %6.2f%%\n",
+            entry->opcode, countString, (100.0*entry->count)/total
+        );
+    }
+
+    STYPE_FREE(all);
+}
+
+//
+// Reset instruction mix counts for a hart
+//
+static void resetMix(riscvP riscv) {
+
+    riscvProfileP  profile = riscv->profile;
+    riscvIType     type;
+    riscvMixEntryP entry;
+
+    for(type=0; type<RV_IT_LAST; type++) {
+        for(entry=profile->mix[type]; entry; entry=entry->next) {
+            entry->count = 0;
+        }
+    }
+}
+
+//
+// Free instruction mix entries for a hart
+//
+static void freeMix(riscvProfileP profile) {
+
+    riscvIType     type;
+    riscvMixEntryP entry;
+
+    for(type=0; type<RV_IT_LAST; type++) {
+        while((entry=profile->mix[type])) {
+            profile->mix[type] = entry->next;
+            STYPE_FREE(entry);
+        }
+    }
+
+    STYPE_FREE(profile->mix);
+}
+
+//
+// Handle dump or reset of instruction mix
+//
+static VMIRT_COMMAND_PARSE_FN(instructionMix) {
+
+    riscvP       riscv    = (riscvP)processor;
+    vmiArgValueP argDump  = vmirtFindArgValue(argc, argv, "dump");
+    vmiArgValueP argReset = vmirtFindArgValue(argc, argv, "reset");
+    Bool         found    = False;
+
+    // handle "dump" argument
+    if(argDump && argDump->isSet) {
+        dumpMix(riscv);
+        found = True;
+    }
+
+    // handle "reset" argument
+    if(argReset && argReset->isSet) {
+        resetMix(riscv);
+        found = True;
+    }
+
+    if(!found) {
+
+        vmiPrintf("%s: -dump -reset\n", INSTRUCTION_MIX_NAME);
+
+        // error status
+        return NULL;
+    }
+
+    return "1";
+}
+
+//
+// Add command for instruction mix dump and reset
+//
+static void addMixCommand(riscvP riscv) {
+
+    vmiCommandP cmd = vmirtAddCommandParse(
+        (vmiProcessorP)riscv,
+        INSTRUCTION_MIX_NAME,
+        "show or reset the instruction mix profile",
+        instructionMix,
+        VMI_CT_DEFAULT|VMI_CO_DIAG|VMI_CA_REPORT
+    );
+
+    const char *dumpHelp  = "print instruction counts by opcode";
+    const char *resetHelp = "reset all instruction counts to zero";
+
+    vmirtAddArg(cmd, "dump",  dumpHelp,  VMI_CA_BOOL, VMI_CAA_DEFAULT, False, 0);
+    vmirtAddArg(cmd, "reset", resetHelp, VMI_CA_BOOL, VMI_CAA_DEFAULT, False, 0);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// HOT BLOCK PROFILE
+////////////////////////////////////////////////////////////////////////////////
+
+#define HOT_BLOCKS_NAME "hotBlocks"
+
+//
+// Number of blocks shown by the hotBlocks command
+//
+#define HOT_BLOCKS_SHOW 32
+
+//
+// Return hash bucket for the given block start address and dictionary mode
+//
+inline static Uns32 getBlockHash(Uns64 PC, riscvDMode dMode) {
+    return ((PC>>1) ^ (PC>>13) ^ dMode) & (BLOCK_HASH_SIZE-1);
+}
+
+//
+// Return the block entry for the given block start address and dictionary
+// mode, creating it if required (a block translated again after a dictionary
+// flush uses the same entry)
+//
+static riscvBlockEntryP getBlockEntry(
+    riscvProfileP profile,
+    Uns64         PC,
+    riscvDMode    dMode
+) {
+    riscvBlockEntryP *bucketP = &profile->blocks[getBlockHash(PC, dMode)];
+    riscvBlockEntryP  entry;
+
+    for(entry=*bucketP; entry; entry=entry->next) {
+        if((entry->PC==PC) && (entry->dMode==dMode)) {
+            return entry;
+        }
+    }
+
+    // create new entry
+    entry        = STYPE_CALLOC(riscvBlockEntry);
+    entry->next  = *bucketP;
+    entry->PC    = PC;
+    entry->dMode = dMode;
+    entry->id    = ++profile->blockNum;
+    *bucketP     = entry;
+
+    return entry;
+}
+
+//
+// Emit code to count execution of a block
+//
+static void emitBlockCount(riscvP riscv, riscvBlockEntryP entry) {
+
+    vmiReg count = vmimtGetExtReg((vmiProcessorP)riscv, &entry->count);
+
+    vmimtBinopRC(64, vmi_ADD, count, 1, 0);
+}
+
+//
+// Compare block entries by decreasing count, then by increasing address
+//
+static Int32 compareBlockEntry(const void *va, const void *vb) {
+
+    riscvBlockEntryP a = *(riscvBlockEntryP *)va;
+    riscvBlockEntryP b = *(riscvBlockEntryP *)vb;
+
+    if(a->count>b->count) {
+        return -1;
+    } else if(a->count<b->count) {
+        return 1;
+    } else if(a->PC<b->PC) {
+        return -1;
+    } else if(a->PC>b->PC) {
+        return 1;
+    } else {
+        return a->dMode-b->dMode;
+    }
+}
+
+//
+// Return an array of all block entries sorted by decreasing count
+//
+static riscvBlockEntryP *getSortedBlocks(riscvProfileP profile) {
+
+    Uns32             max = profile->blockNum;
+    riscvBlockEntryP *all = STYPE_CALLOC_N(riscvBlockEntryP, max+1);
+    Uns32             num = 0;
+    Uns32             i;
+    riscvBlockEntryP  entry;
+
+    for(i=0; i<BLOCK_HASH_SIZE; i++) {
+        for(entry=profile->blocks[i]; entry; entry=entry->next) {
+            all[num++] = entry;
+        }
+    }
+
+    qsort(all, num, sizeof(all[0]), compareBlockEntry);
+
+    return all;
+}
+
+//
+// Fill the name of the symbol containing the block, with offset if the block
+// does not start at the symbol address
+//
+static void getBlockSymbol(riscvP riscv, riscvBlockEntryP entry, char *result) {
+
+    vmiSymbolCP symbol = vmirtGetSymbolByAddr((vmiProcessorP)riscv, entry->PC);
+
+    if(!symbol) {
+        sprintf(result, "0x"FMT_Ax, entry->PC);
+    } else if(vmirtSymbolAddr(symbol)==entry->PC) {
+        sprintf(result, "%s", vmirtSymbolName(symbol));
+    } else {
+        sprintf(
+            result, "%s+0x"FMT_Ax,
+            vmirtSymbolName(symbol), entry->PC-vmirtSymbolAddr(symbol)
+        );
+    }
+}
+
+//
+// Return the name of the dictionary mode of a block
+//
+inline static const char *getBlockModeName(riscvBlockEntryP entry) {
+    return modelAttrs.dictNames[entry->dMode];
+}
+
+//
+// Print the most frequently executed blocks for a hart
+//
+static void dumpBlocks(riscvP riscv, Uns32 maxShow) {
+
+    riscvBlockEntryP *all = getSortedBlocks(riscv->profile);
+    riscvBlockEntryP  entry;
+    Uns32             i;
+
+    vmiPrintf(
+        "Most frequently executed blocks for '%s':\n",
+        vmirtProcessorName((vmiProcessorP)riscv)
+    );
+
+    for(i=0; (i<maxShow) && (entry=all[i]) && entry->count; i++) {
+
+        char countString[32];
+        char symbol[1024];
+
+        sprintf(countString, FMT_Au, entry->count);
+        getBlockSymbol(riscv, entry, symbol);
+
+        vmiPrintf(
+            "  0x"FMT_640Nx" %16s  %-32s %s\n",
+            entry->PC, countString, getBlockModeName(entry), symbol
+        );
+    }
+
+    STYPE_FREE(all);
+}
+
+//
+// Write block counts for a hart to the profile file in collapsed-stack format
+// (one line per block, with frames for hart, dictionary mode and containing
+// symbol), suitable for use as flame graph input. Each hart writes a separate
+// file, suffixed with its processor name (which includes the names of any
+// containing clusters), so harts in different clusters with the same hart
+// index do not overwrite each other.
+//
+static void writeBlocks(riscvP riscv) {
+
+    const char *name = vmirtProcessorName((vmiProcessorP)riscv);
+    char        fileName[1024];
+    FILE       *file;
+
+    snprintf(fileName, sizeof(fileName), "%s.%s", riscv->hotBlockFile, name);
+
+    if(!(file=fopen(fileName, "w"))) {
+
+        vmiMessage("W", CPU_PREFIX"_HBOF",
+            "Unable to open hot block profile file '%s'", fileName
+        );
+
+    } else {
+
+        riscvBlockEntryP *all = getSortedBlocks(riscv->profile);
+        riscvBlockEntryP  entry;
+        Uns32             i;
+
+        for(i=0; (entry=all[i]) && entry->count; i++) {
+
+            char countString[32];
+            char symbol[1024];
+
+            sprintf(countString, FMT_Au, entry->count);
+            getBlockSymbol(riscv, entry, symbol);
+
+            fprintf(
+                file, "%s;%s;%s %s\n",
+                name, getBlockModeName(entry), symbol, countString
+            );
+        }
+
+        STYPE_FREE(all);
+        fclose(file);
+    }
+}
+
+//
+// Reset block counts for a hart
+//
+static void resetBlocks(riscvP riscv) {
+
+    riscvProfileP    profile = riscv->profile;
+    riscvBlockEntryP entry;
+    Uns32            i;
+
+    for(i=0; i<BLOCK_HASH_SIZE; i++) {
+        for(entry=profile->blocks[i]; entry; entry=entry->next) {
+            entry->count = 0;
+        }
+    }
+}
+
+//
+// Free block entries for a hart
+//
+static void freeBlocks(riscvProfileP profile) {
+
+    riscvBlockEntryP entry;
+    Uns32            i;
+
+    for(i=0; i<BLOCK_HASH_SIZE; i++) {
+        while((entry=profile->blocks[i])) {
+            profile->blocks[i] = entry->next;
+            STYPE_FREE(entry);
+        }
+    }
+
+    STYPE_FREE(profile->blocks);
+}
+
+//
+// Handle dump or reset of block counts
+//
+static VMIRT_COMMAND_PARSE_FN(hotBlocks) {
+
+    riscvP       riscv    = (riscvP)processor;
+    vmiArgValueP argDump  = vmirtFindArgValue(argc, argv, "dump");
+    vmiArgValueP argReset = vmirtFindArgValue(argc, argv, "reset");
+    Bool         found    = False;
+
+    // handle "dump" argument
+    if(argDump && argDump->isSet) {
+        dumpBlocks(riscv, HOT_BLOCKS_SHOW);
+        found = True;
+    }
+
+    // handle "reset" argument
+    if(argReset && argReset->isSet) {
+        resetBlocks(riscv);
+        found = True;
+    }
+
+    if(!found) {
+
+        vmiPrintf("%s: -dump -reset\n", HOT_BLOCKS_NAME);
+
+        // error status
+        return NULL;
+    }
+
+    return "1";
+}
+
+//
+// Add command for block count dump and reset
+//
+static void addBlocksCommand(riscvP riscv) {
+
+    vmiCommandP cmd = vmirtAddCommandParse(
+        (vmiProcessorP)riscv,
+        HOT_BLOCKS_NAME,
+        "show or reset the hot block profile",
+        hotBlocks,
+        VMI_CT_DEFAULT|VMI_CO_DIAG|VMI_CA_REPORT
+    );
+
+    const char *dumpHelp  = "print most frequently executed blocks";
+    const char *resetHelp = "reset all block counts to zero";
+
+    vmirtAddArg(cmd, "dump",  dumpHelp,  VMI_CA_BOOL, VMI_CAA_DEFAULT, False, 0);
+    vmirtAddArg(cmd, "reset", resetHelp, VMI_CA_BOOL, VMI_CAA_DEFAULT, False, 0);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// BASIC BLOCK VECTORS
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Emit code to count execution of an instruction in the current block for the
+// basic block vector (so that block counts are weighted by instruction count,
+// including when a block is exited early)
+//
+static void emitBBVCount(riscvP riscv) {
+
+    riscvBlockEntryP entry = riscv->blockState->profileBlock;
+
+    if(entry) {
+
+        vmiReg count = vmimtGetExtReg((vmiProcessorP)riscv, &entry->bbvCount);
+
+        vmimtBinopRC(64, vmi_ADD, count, 1, 0);
+    }
+}
+
+//
+// Write the basic block vector for the current interval in SimPoint format
+// (one line per interval, listing block identifiers and instruction counts),
+// resetting counts for the next interval
+//
+static void writeBBVInterval(riscvP riscv) {
+
+    riscvProfileP    profile = riscv->profile;
+    riscvBlockEntryP entry;
+    Uns32            i;
+
+    // file is opened when first required, suffixed with the processor name
+    // (which includes the names of any containing clusters)
+    if(!profile->bbvFile) {
+
+        const char *name = vmirtProcessorName((vmiProcessorP)riscv);
+        char        fileName[1024];
+
+        snprintf(fileName, sizeof(fileName), "%s.%s", riscv->bbvFile, name);
+
+        if(!(profile->bbvFile=fopen(fileName, "w"))) {
+
+            vmiMessage("W", CPU_PREFIX"_BBOF",
+                "Unable to open basic block vector file '%s'", fileName
+            );
+
+            // disable further intervals
+            profile->bbv = False;
+            return;
+        }
+    }
+
+    fputc('T', profile->bbvFile);
+
+    for(i=0; i<BLOCK_HASH_SIZE; i++) {
+
+        for(entry=profile->blocks[i]; entry; entry=entry->next) {
+
+            if(entry->bbvCount) {
+
+                char countString[32];
+
+                sprintf(countString, FMT_Au, entry->bbvCount);
+                fprintf(profile->bbvFile, ":%u:%s ", entry->id, countString);
+
+                entry->bbvCount = 0;
+            }
+        }
+    }
+
+    fputc('\n', profile->bbvFile);
+}
+
+//
+// Return True if any instructions have been counted in the current interval
+//
+static Bool activeBBVInterval(riscvProfileP profile) {
+
+    riscvBlockEntryP entry;
+    Uns32            i;
+
+    for(i=0; i<BLOCK_HASH_SIZE; i++) {
+        for(entry=profile->blocks[i]; entry; entry=entry->next) {
+            if(entry->bbvCount) {
+                return True;
+            }
+        }
+    }
+
+    return False;
+}
+
+//
+// Basic block vector interval timer expiry
+//
+static VMI_ICOUNT_FN(bbvIntervalCB) {
+
+    riscvP        riscv   = (riscvP)processor;
+    riscvProfileP profile = riscv->profile;
+
+    if(profile->bbv) {
+        writeBBVInterval(riscv);
+        vmirtSetModelTimer(profile->bbvTimer, riscv->bbvInterval);
+    }
+}
+
+//
+// Start basic block vector collection
+//
+static void newBBV(riscvP riscv) {
+
+    riscvProfileP profile = riscv->profile;
+
+    profile->bbv      = True;
+    profile->bbvTimer = vmirtCreateModelTimer(
+        (vmiProcessorP)riscv, bbvIntervalCB, 1, 0
+    );
+
+    vmirtSetModelTimer(profile->bbvTimer, riscv->bbvInterval);
+}
+
+//
+// Write any final partial interval and end basic block vector collection
+//
+static void freeBBV(riscvP riscv) {
+
+    riscvProfileP profile = riscv->profile;
+
+    if(profile->bbv && activeBBVInterval(profile)) {
+        writeBBVInterval(riscv);
+    }
+
+    if(profile->bbvFile) {
+        fclose(profile->bbvFile);
+    }
+
+    vmirtDeleteModelTimer(profile->bbvTimer);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// TRANSLATION STATISTICS
+////////////////////////////////////////////////////////////////////////////////
+
+#define MORPH_STATS_NAME "morphStatistics"
+
+//
+// Return translation statistics for a hart, or NULL if they are not enabled
+//
+inline static riscvMorphStatsP getStats(riscvP riscv) {
+    return riscv->profile ? riscv->profile->stats : 0;
+}
+
+//
+// Print a statistic with a 64-bit count
+//
+static void printStat(const char *name, Uns64 count) {
+
+    char countString[32];
+
+    sprintf(countString, FMT_Au, count);
+
+    vmiPrintf("  %-40s %16s\n", name, countString);
+}
+
+//
+// Print translation statistics for a hart
+//
+static void dumpStats(riscvP riscv) {
+
+    static const char *flushNames[] = {
+        [RVFC_RM_CHECK] = "rounding mode check enabled",
+        [RVFC_ENDIAN]   = "endianness check enabled",
+        [RVFC_TRIGGER]  = "trigger check enabled",
+        [RVFC_BF16]     = "dynamic BF16 check enabled",
+        [RVFC_TMODE]    = "transaction mode enabled",
+    };
+
+    riscvMorphStatsP stats = getStats(riscv);
+    riscvFlushCause  cause;
+    riscvDMode       dMode;
+    riscvIType       type;
+
+    vmiPrintf(
+        "Translation statistics for '%s':\n",
+        vmirtProcessorName((vmiProcessorP)riscv)
+    );
+
+    printStat("blocks translated", stats->blocks);
+    printStat("instructions translated", stats->instructions);
+    printStat("polymorphic key changes", stats->pmKeyChanges);
+
+    vmiPrintf(
+        "  %-40s %16.3f\n", "translation time (host seconds)",
+        (double)stats->morphTime/CLOCKS_PER_SEC
+    );
+
+    vmiPrintf("Dictionary flushes by cause:\n");
+
+    for(cause=0; cause<RVFC_LAST; cause++) {
+        printStat(flushNames[cause], stats->flushes[cause]);
+    }
+
+    vmiPrintf("Bytes translated by dictionary mode:\n");
+
+    for(dMode=0; dMode<RISCV_DMODE_LAST; dMode++) {
+        if(stats->bytes[dMode]) {
+            printStat(modelAttrs.dictNames[dMode], stats->bytes[dMode]);
+        }
+    }
+
+    vmiPrintf("Instructions translated by type (example opcode):\n");
+
+    for(type=0; type<=RV_IT_LAST; type++) {
+        if(stats->types[type]) {
+            printStat(stats->names[type], stats->types[type]);
+        }
+    }
+}
+
+//
+// Reset translation statistics for a hart
+//
+static void resetStats(riscvP riscv) {
+
+    riscvMorphStatsP stats = getStats(riscv);
+
+    stats->blocks       = 0;
+    stats->instructions = 0;
+    stats->pmKeyChanges = 0;
+    stats->morphTime    = 0;
+
+    memset(stats->flushes, 0, sizeof(stats->flushes));
+    memset(stats->bytes,   0, sizeof(stats->bytes));
+    memset(stats->types,   0, sizeof(stats->types));
+}
+
+//
+// Handle dump or reset of translation statistics
+//
+static VMIRT_COMMAND_PARSE_FN(morphStatistics) {
+
+    riscvP       riscv    = (riscvP)processor;
+    vmiArgValueP argDump  = vmirtFindArgValue(argc, argv, "dump");
+    vmiArgValueP argReset = vmirtFindArgValue(argc, argv, "reset");
+    Bool         found    = False;
+
+    // handle "dump" argument
+    if(argDump && argDump->isSet) {
+        dumpStats(riscv);
+        found = True;
+    }
+
+    // handle "reset" argument
+    if(argReset && argReset->isSet) {
+        resetStats(riscv);
+        found = True;
+    }
+
+    if(!found) {
+
+        vmiPrintf("%s: -dump -reset\n", MORPH_STATS_NAME);
+
+        // error status
+        return NULL;
+    }
+
+    return "1";
+}
+
+//
+// Add command for translation statistics dump and reset
+//
+static void addStatsCommand(riscvP riscv) {
+
+    vmiCommandP cmd = vmirtAddCommandParse(
+        (vmiProcessorP)riscv,
+        MORPH_STATS_NAME,
+        "show or reset code translation statistics",
+        morphStatistics,
+        VMI_CT_DEFAULT|VMI_CO_DIAG|VMI_CA_REPORT
+    );
+
+    const char *dumpHelp  = "print translation statistics";
+    const char *resetHelp = "reset all translation statistics to zero";
+
+    vmirtAddArg(cmd, "dump",  dumpHelp,  VMI_CA_BOOL, VMI_CAA_DEFAULT, False, 0);
+    vmirtAddArg(cmd, "reset", resetHelp, VMI_CA_BOOL, VMI_CAA_DEFAULT, False, 0);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// MEMORY ACCESS PROFILE
+////////////////////////////////////////////////////////////////////////////////
+
+#define MEMORY_PROFILE_NAME "memoryProfile"
+
+//
+// Number of pages and sites shown by the memoryProfile command
+//
+#define MEMORY_PROFILE_SHOW 16
+
+//
+// Return hash bucket for the given virtual page number
+//
+inline static Uns32 getPageHash(Uns64 page) {
+    return (page ^ (page>>12)) & (PAGE_HASH_SIZE-1);
+}
+
+//
+// Return the page entry for the given virtual page number, creating it if
+// required
+//
+static riscvPageEntryP getPageEntry(riscvMemProfileP mem, Uns64 page) {
+
+    riscvPageEntryP *bucketP = &mem->pages[getPageHash(page)];
+    riscvPageEntryP  entry;
+
+    for(entry=*bucketP; entry; entry=entry->next) {
+        if(entry->page==page) {
+            return entry;
+        }
+    }
+
+    // create new entry
+    entry       = STYPE_CALLOC(riscvPageEntry);
+    entry->next = *bucketP;
+    entry->page = page;
+    *bucketP    = entry;
+
+    mem->pageNum++;
+
+    return entry;
+}
+
+//
+// Emit code to count execution of an instruction in its page
+//
+static void emitPageExecCount(riscvP riscv, Uns64 PC) {
+
+    riscvMemProfileP mem   = riscv->profile->mem;
+    riscvPageEntryP  entry = getPageEntry(mem, PC>>MEM_PAGE_SHIFT);
+    vmiReg           count = vmimtGetExtReg((vmiProcessorP)riscv, &entry->execs);
+
+    // mark the line containing the instruction as accessed
+    entry->lines |= 1ULL << ((PC>>MEM_LINE_SHIFT) & 63);
+
+    vmimtBinopRC(64, vmi_ADD, count, 1, 0);
+}
+
+//
+// Record a load or store (called from JIT code before each access)
+//
+static void profileAccess(riscvP riscv, Uns64 base, riscvAccessSiteP site) {
+
+    riscvMemProfileP mem  = riscv->profile->mem;
+    Uns64            VA   = base+site->offset;
+    Uns64            line;
+    riscvPageEntryP  entry;
+
+    if(site->is32) {
+        VA = (Uns32)VA;
+    }
+
+    line  = VA>>MEM_LINE_SHIFT;
+    entry = getPageEntry(mem, VA>>MEM_PAGE_SHIFT);
+
+    // update page counts and accessed lines
+    if(site->isStore) {
+        entry->writes++;
+    } else {
+        entry->reads++;
+    }
+
+    entry->lines |= 1ULL << (line & 63);
+
+    // update site counts
+    if(site->accesses && (line!=site->lastLine)) {
+        site->changes++;
+    }
+
+    site->accesses++;
+    site->lastLine = line;
+    site->lastVA   = VA;
+}
+
+//
+// Return the access site for a load or store at the given address, creating it
+// if required (a site translated again after a dictionary flush uses the same
+// entry, so that sites are not allocated again for each translation)
+//
+static riscvAccessSiteP getAccessSite(
+    riscvMemProfileP mem,
+    Uns64            PC,
+    Uns64            offset,
+    Uns32            bytes,
+    Bool             isStore,
+    Bool             is32
+) {
+    riscvAccessSiteP *bucketP = &mem->sites[(PC>>1) & (SITE_HASH_SIZE-1)];
+    riscvAccessSiteP  site;
+
+    for(site=*bucketP; site; site=site->next) {
+        if(
+            (site->PC==PC) && (site->offset==offset) && (site->bytes==bytes) &&
+            (site->isStore==isStore) && (site->is32==is32)
+        ) {
+            return site;
+        }
+    }
+
+    // create new site
+    site          = STYPE_CALLOC(riscvAccessSite);
+    site->next    = *bucketP;
+    site->PC      = PC;
+    site->offset  = offset;
+    site->bytes   = bytes;
+    site->isStore = isStore;
+    site->is32    = is32;
+    *bucketP      = site;
+
+    mem->siteNum++;
+
+    return site;
+}
+
+//
+// Emit code to profile a load or store with address ra+offset
+//
+static void emitAccessProfile(
+    riscvP riscv,
+    vmiReg ra,
+    Uns64  offset,
+    Uns32  memBits,
+    Bool   isStore
+) {
+    riscvMemProfileP mem    = riscv->profile->mem;
+    Uns32            raBits = riscvGetXlenMode(riscv);
+    Uns64            PC     = vmirtGetPC((vmiProcessorP)riscv);
+    riscvAccessSiteP site   = getAccessSite(
+        mem, PC, offset, memBits/8, isStore, raBits==32
+    );
+
+    vmimtArgProcessor();
+
+    if(VMI_ISNOREG(ra)) {
+        vmimtArgUns64(0);
+    } else {
+        vmimtArgRegSimAddress(raBits, ra);
+    }
+
+    vmimtArgNatAddress(site);
+    vmimtCall((vmiCallFn)profileAccess);
+}
+
+//
+// Return the number of lines accessed in a page
+//
+inline static Uns32 getPageLines(riscvPageEntryP entry) {
+    return __builtin_popcountll(entry->lines);
+}
+
+//
+// Return total accesses to a page
+//
+inline static Uns64 getPageAccesses(riscvPageEntryP entry) {
+    return entry->reads+entry->writes+entry->execs;
+}
+
+//
+// Compare page entries by decreasing total accesses, then by page number
+//
+static Int32 comparePageEntry(const void *va, const void *vb) {
+
+    riscvPageEntryP a  = *(riscvPageEntryP *)va;
+    riscvPageEntryP b  = *(riscvPageEntryP *)vb;
+    Uns64           aN = getPageAccesses(a);
+    Uns64           bN = getPageAccesses(b);
+
+    if(aN>bN) {
+        return -1;
+    } else if(aN<bN) {
+        return 1;
+    } else if(a->page<b->page) {
+        return -1;
+    } else {
+        return (a->page>b->page);
+    }
+}
+
+//
+// Compare access sites by decreasing line changes, then by address
+//
+static Int32 compareAccessSite(const void *va, const void *vb) {
+
+    riscvAccessSiteP a = *(riscvAccessSiteP *)va;
+    riscvAccessSiteP b = *(riscvAccessSiteP *)vb;
+
+    if(a->changes>b->changes) {
+        return -1;
+    } else if(a->changes<b->changes) {
+        return 1;
+    } else if(a->PC<b->PC) {
+        return -1;
+    } else {
+        return (a->PC>b->PC);
+    }
+}
+
+//
+// Print memory access profile for a hart
+//
+static void dumpMemory(riscvP riscv) {
+
+    riscvMemProfileP  mem     = riscv->profile->mem;
+    riscvPageEntryP  *pages   = STYPE_CALLOC_N(riscvPageEntryP, mem->pageNum+1);
+    riscvAccessSiteP *sites   = STYPE_CALLOC_N(riscvAccessSiteP, mem->siteNum+1);
+    Uns32             pageNum = 0;
+    Uns32             siteNum = 0;
+    Uns64             lines   = 0;
+    Uns64             touched = 0;
+    riscvPageEntryP   entry;
+    riscvAccessSiteP  site;
+    Uns32             i;
+
+    // collect touched pages and total accessed lines
+    for(i=0; i<PAGE_HASH_SIZE; i++) {
+        for(entry=mem->pages[i]; entry; entry=entry->next) {
+            if(getPageAccesses(entry)) {
+                pages[pageNum++] = entry;
+                lines += getPageLines(entry);
+                touched++;
+            }
+        }
+    }
+
+    // collect sites with accesses
+    for(i=0; i<SITE_HASH_SIZE; i++) {
+        for(site=mem->sites[i]; site; site=site->next) {
+            if(site->accesses) {
+                sites[siteNum++] = site;
+            }
+        }
+    }
+
+    qsort(pages, pageNum, sizeof(pages[0]), comparePageEntry);
+    qsort(sites, siteNum, sizeof(sites[0]), compareAccessSite);
+
+    vmiPrintf(
+        "Memory access profile for '%s':\n",
+        vmirtProcessorName((vmiProcessorP)riscv)
+    );
+    printStat("pages touched", touched);
+    printStat("page working set (bytes)", touched<<MEM_PAGE_SHIFT);
+    printStat("line footprint (bytes)", lines<<MEM_LINE_SHIFT);
+
+    vmiPrintf("Most frequently accessed pages (reads, writes, executes, lines):\n");
+
+    for(i=0; (i<MEMORY_PROFILE_SHOW) && (i<pageNum); i++) {
+
+        char readString[32];
+        char writeString[32];
+        char execString[32];
+
+        entry = pages[i];
+
+        sprintf(readString,  FMT_Au, entry->reads);
+        sprintf(writeString, FMT_Au, entry->writes);
+        sprintf(execString,  FMT_Au, entry->execs);
+
+        vmiPrintf(
+            "  0x"FMT_640Nx" %16s %16s %16s %3u\n",
+            entry->page<<MEM_PAGE_SHIFT,
+            readString, writeString, execString, getPageLines(entry)
+        );
+    }
+
+    vmiPrintf("Access sites with most line changes (accesses, changes, last address):\n");
+
+    for(i=0; (i<MEMORY_PROFILE_SHOW) && (i<siteNum) && sites[i]->changes; i++) {
+
+        char accessString[32];
+        char changeString[32];
+
+        site = sites[i];
+
+        sprintf(accessString, FMT_Au, site->accesses);
+        sprintf(changeString, FMT_Au, site->changes);
+
+        vmiPrintf(
+            "  0x"FMT_640Nx" %-5s %16s %16s 0x"FMT_640Nx"\n",
+            site->PC, site->isStore ? "store" : "load",
+            accessString, changeString, site->lastVA
+        );
+    }
+
+    STYPE_FREE(pages);
+    STYPE_FREE(sites);
+}
+
+//
+// Reset memory access profile for a hart
+//
+static void resetMemory(riscvP riscv) {
+
+    riscvMemProfileP mem = riscv->profile->mem;
+    riscvPageEntryP  entry;
+    riscvAccessSiteP site;
+    Uns32            i;
+
+    for(i=0; i<PAGE_HASH_SIZE; i++) {
+        for(entry=mem->pages[i]; entry; entry=entry->next) {
+            entry->reads  = 0;
+            entry->writes = 0;
+            entry->execs  = 0;
+            entry->lines  = 0;
+        }
+    }
+
+    for(i=0; i<SITE_HASH_SIZE; i++) {
+        for(site=mem->sites[i]; site; site=site->next) {
+            site->accesses = 0;
+            site->changes  = 0;
+        }
+    }
+}
+
+//
+// Free memory access profile for a hart
+//
+static void freeMemory(riscvProfileP profile) {
+
+    riscvMemProfileP mem = profile->mem;
+    riscvPageEntryP  entry;
+    riscvAccessSiteP site;
+    Uns32            i;
+
+    for(i=0; i<PAGE_HASH_SIZE; i++) {
+        while((entry=mem->pages[i])) {
+            mem->pages[i] = entry->next;
+            STYPE_FREE(entry);
+        }
+    }
+
+    for(i=0; i<SITE_HASH_SIZE; i++) {
+        while((site=mem->sites[i])) {
+            mem->sites[i] = site->next;
+            STYPE_FREE(site);
+        }
+    }
+
+    STYPE_FREE(mem->pages);
+    STYPE_FREE(mem->sites);
+    STYPE_FREE(mem);
+}
+
+//
+// Handle dump or reset of memory access profile
+//
+static VMIRT_COMMAND_PARSE_FN(memoryProfile) {
+
+    riscvP       riscv    = (riscvP)processor;
+    vmiArgValueP argDump  = vmirtFindArgValue(argc, argv, "dump");
+    vmiArgValueP argReset = vmirtFindArgValue(argc, argv, "reset");
+    Bool         found    = False;
+
+    // handle "dump" argument
+    if(argDump && argDump->isSet) {
+        dumpMemory(riscv);
+        found = True;
+    }
+
+    // handle "reset" argument
+    if(argReset && argReset->isSet) {
+        resetMemory(riscv);
+        found = True;
+    }
+
+    if(!found) {
+
+        vmiPrintf("%s: -dump -reset\n", MEMORY_PROFILE_NAME);
+
+        // error status
+        return NULL;
+    }
+
+    return "1";
+}
+
+//
+// Add command for memory access profile dump and reset
+//
+static void addMemoryCommand(riscvP riscv) {
+
+    vmiCommandP cmd = vmirtAddCommandParse(
+        (vmiProcessorP)riscv,
+        MEMORY_PROFILE_NAME,
+        "show or reset the memory access profile",
+        memoryProfile,
+        VMI_CT_DEFAULT|VMI_CO_DIAG|VMI_CA_REPORT
+    );
+
+    const char *dumpHelp  = "print page and access site statistics";
+    const char *resetHelp = "reset all memory access counts to zero";
+
+    vmirtAddArg(cmd, "dump",  dumpHelp,  VMI_CA_BOOL, VMI_CAA_DEFAULT, False, 0);
+    vmirtAddArg(cmd, "reset", resetHelp, VMI_CA_BOOL, VMI_CAA_DEFAULT, False, 0);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// PUBLIC INTERFACE
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Allocate profiling structures and commands for a hart if required
+//
+void riscvNewProfile(riscvP riscv) {
+
+    Bool hotBlocks = riscv->hotBlockFile && riscv->hotBlockFile[0];
+    Bool bbv       = riscv->bbvFile && riscv->bbvFile[0];
+
+    riscvProfileP profile;
+
+    if(
+        riscv->instrMix || hotBlocks || bbv || riscv->morphStats ||
+        riscv->memProfile
+    ) {
+        profile = riscv->profile = STYPE_CALLOC(riscvProfile);
+    } else {
+        return;
+    }
+
+    // allocate instruction mix structures and command
+    if(riscv->instrMix) {
+        profile->mix = STYPE_CALLOC_N(riscvMixEntryP, RV_IT_LAST);
+        addMixCommand(riscv);
+    }
+
+    // allocate block structures (shared by hot block profile and basic block
+    // vectors)
+    if(hotBlocks || bbv) {
+        profile->blocks = STYPE_CALLOC_N(riscvBlockEntryP, BLOCK_HASH_SIZE);
+    }
+
+    // add hot block command
+    if(hotBlocks) {
+        profile->hotBlocks = True;
+        addBlocksCommand(riscv);
+    }
+
+    // start basic block vector collection
+    if(bbv) {
+        newBBV(riscv);
+    }
+
+    // allocate translation statistics and command
+    if(riscv->morphStats) {
+        profile->stats = STYPE_CALLOC(riscvMorphStats);
+        addStatsCommand(riscv);
+    }
+
+    // allocate memory access profile structures and command
+    if(riscv->memProfile) {
+        profile->mem        = STYPE_CALLOC(riscvMemProfile);
+        profile->mem->pages = STYPE_CALLOC_N(riscvPageEntryP, PAGE_HASH_SIZE);
+        profile->mem->sites = STYPE_CALLOC_N(riscvAccessSiteP, SITE_HASH_SIZE);
+        addMemoryCommand(riscv);
+    }
+}
+
+//
+// Report and free profiling structures for a hart
+//
+void riscvFreeProfile(riscvP riscv) {
+
+    riscvProfileP profile = riscv->profile;
+
+    if(profile) {
+
+        // report instruction mix at end of simulation
+        if(profile->mix) {
+            dumpMix(riscv);
+            freeMix(profile);
+        }
+
+        // write hot block profile at end of simulation
+        if(profile->hotBlocks) {
+            writeBlocks(riscv);
+        }
+
+        // write final basic block vector interval at end of simulation
+        if(profile->bbvTimer) {
+            freeBBV(riscv);
+        }
+
+        if(profile->blocks) {
+            freeBlocks(profile);
+        }
+
+        // report translation statistics at end of simulation
+        if(profile->stats) {
+            dumpStats(riscv);
+            STYPE_FREE(profile->stats);
+        }
+
+        // report memory access profile at end of simulation
+        if(profile->mem) {
+            dumpMemory(riscv);
+            freeMemory(profile);
+        }
+
+        STYPE_FREE(profile);
+        riscv->profile = 0;
+    }
+}
+
+//
+// Emit code to count execution of the decoded instruction if instruction mix,
+// basic block vector or memory access profiling is enabled
+//
+void riscvEmitProfileInstruction(riscvP riscv, riscvInstrInfoP info) {
+
+    riscvProfileP profile = riscv->profile;
+
+    if(profile && profile->mix) {
+        emitMixCount(riscv, info);
+    }
+
+    if(profile && profile->bbv) {
+        emitBBVCount(riscv);
+    }
+
+    if(profile && profile->mem) {
+        emitPageExecCount(riscv, info->thisPC);
+    }
+}
+
+//
+// Emit code to count execution of the block starting at the given address if
+// hot block profiling is enabled, and note the block for basic block vectors
+//
+void riscvEmitProfileBlock(riscvP riscv, Uns64 PC) {
+
+    riscvProfileP profile = riscv->profile;
+
+    if(profile && profile->blocks) {
+
+        riscvBlockEntryP entry = getBlockEntry(profile, PC, riscv->mode);
+
+        // instructions in the block are counted in this entry
+        riscv->blockState->profileBlock = entry;
+
+        if(profile->hotBlocks) {
+            emitBlockCount(riscv, entry);
+        }
+    }
+}
+
+//
+// Record start of translation of a block (nested blocks are included in the
+// time of the outer block)
+//
+void riscvProfileBlockStart(riscvP riscv, Bool outer) {
+
+    riscvMorphStatsP stats = getStats(riscv);
+
+    if(stats) {
+
+        stats->blocks++;
+
+        if(outer) {
+            stats->blockStart = clock();
+        }
+    }
+}
+
+//
+// Record end of translation of a block
+//
+void riscvProfileBlockEnd(riscvP riscv, Bool outer) {
+
+    riscvMorphStatsP stats = getStats(riscv);
+
+    if(stats && outer) {
+        stats->morphTime += clock()-stats->blockStart;
+    }
+}
+
+//
+// Record translation of the decoded instruction
+//
+void riscvProfileTranslate(riscvP riscv, riscvInstrInfoP info) {
+
+    riscvMorphStatsP stats = getStats(riscv);
+
+    if(stats) {
+
+        riscvIType type = info->type;
+
+        stats->instructions++;
+        stats->types[type]++;
+        stats->bytes[riscv->mode] += info->bytes;
+
+        // record example opcode name for the type
+        if(stats->names[type]) {
+            // no action
+        } else if(type==RV_IT_LAST) {
+            stats->names[type] = "(undecoded)";
+        } else {
+            stats->names[type] = info->opcode ? info->opcode : "?";
+        }
+    }
+}
+
+//
+// Record a dictionary flush with the given cause
+//
+void riscvProfileFlush(riscvP riscv, riscvFlushCause cause) {
+
+    riscvMorphStatsP stats = getStats(riscv);
+
+    if(stats) {
+        stats->flushes[cause]++;
+    }
+}
+
+//
+// Record a change of polymorphic block key
+//
+void riscvProfilePMKeyChange(riscvP riscv) {
+
+    riscvMorphStatsP stats = getStats(riscv);
+
+    if(stats) {
+        stats->pmKeyChanges++;
+    }
+}
+
+//
+// Emit code to profile a load or store with address ra+offset if memory
+// access profiling is enabled
+//
+void riscvEmitProfileAccess(
+    riscvP riscv,
+    vmiReg ra,
+    Uns64  offset,
+    Uns32  memBits,
+    Bool   isStore
+) {
+    riscvProfileP profile = riscv->profile;
+
+    if(profile && profile->mem) {
+        emitAccessProfile(riscv, ra, offset, memBits, isStore);
+    }
+}
+
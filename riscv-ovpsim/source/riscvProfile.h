@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2005-2023 Imperas Software Ltd., www.imperas.com
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+// VMI header files
+#include "vmi/vmiTypes.h"
+
+// model header files
+#include "riscvTypeRefs.h"
+
+//
+// This enumerates causes of dictionary flushes (reported in translation
+// statistics)
+//
+typedef enum riscvFlushCauseE {
+    RVFC_RM_CHECK,      // rounding mode validity check enabled
+    RVFC_ENDIAN,        // endianness check enabled
+    RVFC_TRIGGER,       // trigger check enabled
+    RVFC_BF16,          // dynamic BFLOAT16 check enabled
+    RVFC_TMODE,         // transaction mode enabled
+    RVFC_LAST           // KEEP LAST: for sizing
+} riscvFlushCause;
+
+
+//
+// Allocate profiling structures and commands for a hart if required
+//
+void riscvNewProfile(riscvP riscv);
+
+//
+// Report and free profiling structures for a hart
+//
+void riscvFreeProfile(riscvP riscv);
+
+//
+// Emit code to count execution of the decoded instruction if instruction mix,
+// basic block vector or memory access profiling is enabled
+//
+void riscvEmitProfileInstruction(riscvP riscv, riscvInstrInfoP info);
+
+//
+// Emit code to count execution of the block starting at the given address if
+// hot block profiling is enabled, and note the block for basic block vectors
+//
+void riscvEmitProfileBlock(riscvP riscv, Uns64 PC);
+
+//
+// Record start of translation of a block
+//
+void riscvProfileBlockStart(riscvP riscv, Bool outer);
+
+//
+// Record end of translation of a block
+//
+void riscvProfileBlockEnd(riscvP riscv, Bool outer);
+
+//
+// Record translation of the decoded instruction
+//
+void riscvProfileTranslate(riscvP riscv, riscvInstrInfoP info);
+
+//
+// Record a dictionary flush with the given cause
+//
+void riscvProfileFlush(riscvP riscv, riscvFlushCause cause);
+
+//
+// Record a change of polymorphic block key
+//
+void riscvProfilePMKeyChange(riscvP riscv);
+
+//
+// Emit code to profile a load or store with address ra+offset if memory
+// access profiling is enabled
+//
+void riscvEmitProfileAccess(
+    riscvP riscv,
+    vmiReg ra,
+    Uns64  offset,
+    Uns32  memBits,
+    Bool   isStore
+);
+
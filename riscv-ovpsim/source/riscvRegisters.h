@@ -94,6 +94,7 @@ typedef enum rvRegE {
 #define RISCV_VPRED_MASK        RISCV_CPU_TEMP(vFieldMask)
 #define RISCV_VACTIVE_MASK      RISCV_CPU_TEMP(vActiveMask)
 #define RISCV_VTMP              RISCV_CPU_TEMP(vTmp)
+#define RISCV_VTMP_I(_I)        RISCV_CPU_TEMP(vTmp[_I])
 #define RISCV_VSTATE            RISCV_CPU_TEMP(vState)
 #define RISCV_FF                RISCV_CPU_REG(vFirstFault)
 #define RISCV_PRESERVE          RISCV_CPU_REG(vPreserve)
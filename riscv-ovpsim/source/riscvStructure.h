@@ -230,6 +230,22 @@ typedef struct riscvTriggerS {
 #define LMUL_MAX        8
 #define NUM_BASE_REGS   4
 
+//
+// Size of instruction fetch buffer used during code translation (a power of
+// two, with one valid bit per halfword in riscvFetchBuffer.valid)
+//
+#define FETCH_BUFFER_BYTES 64
+
+//
+// Instruction fetch buffer, holding halfwords already fetched from one aligned
+// chunk of code while a block is being translated
+//
+typedef struct riscvFetchBufferS {
+    Uns64 base;                             // base address of buffered chunk
+    Uns32 valid;                            // mask of valid halfwords
+    Uns16 half[FETCH_BUFFER_BYTES/2];       // buffered instruction halfwords
+} riscvFetchBuffer;
+
 //
 // Processor model structure
 //
@@ -253,6 +269,15 @@ typedef struct riscvS {
     Uns32              hartNum;         // index number within cluster
     Bool               verbose       :1;// whether verbose output enabled
     Bool               traceVolatile :1;// whether to trace volatile registers
+    Bool               fusePairs     :1;// whether instruction pair fusion enabled
+    Bool               instrMix      :1;// whether instruction mix profiling enabled
+    Bool               morphStats    :1;// whether translation statistics enabled
+    Bool               memProfile    :1;// whether memory access profile enabled
+    Bool               binTraceMem   :1;// whether binary trace includes accesses
+    Bool               hpmModel      :1;// whether model HPM events enabled
+    Bool               cycleModel    :1;// whether approximate cycles modeled
+    Bool               vectorKernels :1;// whether vector host kernels enabled
+    Bool               vfredTree     :1;// whether vfredusum uses partial sums
     Bool               artifactAccess:1;// whether artifact access active
     Bool               artifactLdSt  :1;// whether artifact load/store active
     Bool               externalActive:1;// whether external CSR access active
@@ -293,6 +318,8 @@ typedef struct riscvS {
     memEndian          dendian;         // data endianness
     Uns64              jumpBase;        // address of jump instruction
     Uns32              writtenXMask;    // mask of written X registers
+    Uns32              writtenFMask;    // mask of written F registers
+    Uns32              writtenVMask;    // mask of written V registers
 
     // Configuration and parameter definitions
     riscvParamValuesP  paramValues;     // specified parameters (construction only)
@@ -337,6 +364,10 @@ typedef struct riscvS {
     Uns64              mtimebase;       // mtime base value
     Uns64              baseCycles;      // base cycle count
     Uns64              baseInstructions;// base instruction count
+    Uns64              pendingCycles;   // cycles not yet added to count
+    Uns64              hpmEvents[RVHE_LAST];// model event counts
+    Uns64              hpmBase[32];     // mhpmcounter base event counts
+    Uns8               hpmEvent[32];    // mhpmevent selected events
 
     // Debug and trace
     octSymbolTableP    regNames;        // table of generated register names
@@ -452,6 +483,24 @@ typedef struct riscvS {
     // Decoder support
     vmidDecodeTableP   table16;                 // 16-bit decode table
     vmidDecodeTableP   table32;                 // 32-bit decode table
+    riscvFetchBuffer   fetchBuffer;             // translation fetch buffer
+
+    // Profiling support
+    riscvProfileP      profile;                 // profiling state (if enabled)
+    const char        *hotBlockFile;            // hot block profile file (if any)
+    riscvTraceP        trace;                   // binary trace state (if enabled)
+    const char        *binaryTraceFile;         // binary trace file (if any)
+    const char        *commitLogName;           // commit log shared memory (if any)
+    const char        *bbvFile;                 // basic block vector file (if any)
+    Uns64              bbvInterval;             // basic block vector interval
+    riscvTimingP       timing;                  // approximate timing (if enabled)
+    const char        *cycleLatency;            // latency specification (if any)
+    riscvCacheModelP   cache;                   // cache models (if enabled)
+    const char        *icacheSpec;              // instruction cache (if any)
+    const char        *dcacheSpec;              // data cache (if any)
+    Uns32              cacheSample;             // cache sampling interval
+    riscvBranchModelP  branch;                  // branch predictor (if enabled)
+    const char        *branchSpec;              // branch predictor (if any)
 
 } riscv;
 
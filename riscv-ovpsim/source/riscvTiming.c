@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2005-2023 Imperas Software Ltd., www.imperas.com
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Standard header files
+#include <stdlib.h>
+#include <string.h>
+
+// Imperas header files
+#include "hostapi/impAlloc.h"
+
+// VMI header files
+#include "vmi/vmiMessage.h"
+#include "vmi/vmiMt.h"
+#include "vmi/vmiRt.h"
+
+// model header files
+#include "riscvBlockState.h"
+#include "riscvMessage.h"
+#include "riscvMorph.h"
+#include "riscvRegisters.h"
+#include "riscvStructure.h"
+#include "riscvTiming.h"
+
+
+//
+// This holds approximate timing state for a hart
+//
+typedef struct riscvTimingS {
+    Uns32 latency[RVLC_LAST];   // cycles for each latency class
+} riscvTiming;
+
+//
+// Latency class names used in parameter cycle_latency
+//
+static const char *classNames[RVLC_LAST] = {
+    [RVLC_INT]    = "int",
+    [RVLC_MUL]    = "mul",
+    [RVLC_DIV]    = "div",
+    [RVLC_FP]     = "fp",
+    [RVLC_FDIV]   = "fdiv",
+    [RVLC_LOAD]   = "load",
+    [RVLC_STORE]  = "store",
+    [RVLC_CSR]    = "csr",
+    [RVLC_VECTOR] = "vector",
+};
+
+//
+// Return the latency class with the given name (of the given length), or
+// RVLC_LAST if there is none
+//
+static riscvLatencyClass findClass(const char *name, Uns32 length) {
+
+    riscvLatencyClass class;
+
+    for(class=0; class<RVLC_LAST; class++) {
+        if((strlen(classNames[class])==length) && !strncmp(classNames[class], name, length)) {
+            break;
+        }
+    }
+
+    return class;
+}
+
+//
+// Parse a latency specification of the form "class=cycles,class=cycles,..."
+// into the timing structure, returning False if it is malformed
+//
+static Bool parseLatency(riscvTimingP timing, const char *spec) {
+
+    const char *s = spec;
+
+    while(*s) {
+
+        const char        *eq = strchr(s, '=');
+        riscvLatencyClass  class;
+        char              *end;
+        Uns32              value;
+
+        if(!eq) {
+            return False;
+        } else if((class=findClass(s, eq-s))==RVLC_LAST) {
+            return False;
+        }
+
+        value = strtoul(eq+1, &end, 0);
+
+        if((end==eq+1) || !value || (*end && (*end!=','))) {
+            return False;
+        }
+
+        timing->latency[class] = value;
+
+        s = *end ? end+1 : end;
+    }
+
+    return True;
+}
+
+//
+// Allocate approximate timing structures for a hart if required
+//
+void riscvNewTiming(riscvP riscv) {
+
+    const char *spec = riscv->cycleLatency;
+
+    if(spec && spec[0]) {
+
+        riscvTimingP      timing = STYPE_CALLOC(riscvTiming);
+        riscvLatencyClass class;
+
+        // all classes take a single cycle by default
+        for(class=0; class<RVLC_LAST; class++) {
+            timing->latency[class] = 1;
+        }
+
+        if(parseLatency(timing, spec)) {
+
+            riscv->timing     = timing;
+            riscv->cycleModel = True;
+
+        } else {
+
+            vmiMessage("W", CPU_PREFIX"_ICL",
+                "Invalid cycle_latency specification '%s' - expected "
+                "comma-separated class=cycles, with class one of int, mul, "
+                "div, fp, fdiv, load, store, csr or vector (ignored)",
+                spec
+            );
+
+            STYPE_FREE(timing);
+        }
+    }
+}
+
+//
+// Free approximate timing structures for a hart
+//
+void riscvFreeTiming(riscvP riscv) {
+
+    if(riscv->timing) {
+        STYPE_FREE(riscv->timing);
+        riscv->timing = 0;
+    }
+}
+
+//
+// Add cycles accounted by previously-executed blocks to the processor cycle
+// count, so that they are seen by model timers
+//
+static void flushPendingCycles(riscvP riscv) {
+
+    Uns64 pending = riscv->pendingCycles;
+
+    if(pending) {
+        riscv->pendingCycles = 0;
+        vmirtAddSkipCount((vmiProcessorP)riscv, pending, False);
+    }
+}
+
+//
+// Return the number of registers in the active vector register group (or 1 if
+// LMUL is fractional). If LMUL is not yet known in this block, the current
+// value is used and the block is made polymorphic on it.
+//
+static Uns32 getGroupRegisters(riscvP riscv) {
+
+    riscvVLMULx8Mt VLMULx8 = riscvGetVLMULx8Mt(riscv);
+
+    return (VLMULx8>VLMULx8MT_1) ? VLMULx8/VLMULx8MT_1 : 1;
+}
+
+//
+// Emit code to transfer pending cycles (accounted by previously-executed
+// blocks) to the processor cycle count if approximate cycles are modeled. This
+// is emitted with the first instruction in a block that may itself account
+// cycles, so blocks that account none have no flush overhead.
+//
+void riscvEmitTimingFlush(riscvP riscv) {
+
+    riscvBlockStateP blockState = riscv->blockState;
+
+    if(riscv->cycleModel && blockState->flushCycles) {
+        blockState->flushCycles = False;
+        vmimtArgProcessor();
+        vmimtCall((vmiCallFn)flushPendingCycles);
+    }
+}
+
+//
+// Emit code to account the latency of an instruction of the given class if
+// approximate timing is enabled. Each instruction already counts as one cycle,
+// so only the excess latency is added (by an inlined add to pendingCycles).
+//
+void riscvEmitTimingInstruction(
+    riscvP            riscv,
+    riscvLatencyClass class,
+    Uns32             vregs
+) {
+    riscvTimingP timing = riscv->timing;
+
+    if(timing) {
+
+        Uns32 cycles = timing->latency[class];
+
+        // vector latency is per register of the active group, unless the
+        // number of registers is fixed by the instruction (LMUL is then not
+        // looked up, so the block is not made polymorphic on it)
+        if((class==RVLC_VECTOR) && (cycles>1)) {
+            cycles *= vregs ? vregs : getGroupRegisters(riscv);
+        }
+
+        // account excess latency
+        if(cycles>1) {
+            riscvEmitTimingFlush(riscv);
+            vmimtBinopRC(64, vmi_ADD, RISCV_CPU_REG(pendingCycles), cycles-1, 0);
+        }
+    }
+}
+
+//
+// Return cycles accounted but not yet added to the processor cycle count
+//
+Uns64 riscvGetPendingCycles(riscvP riscv) {
+    return riscv->pendingCycles;
+}
+
+//
+// Add cycles from a runtime model (for example, cache miss penalty) to the
+// approximate cycle count
+//
+void riscvAddPendingCycles(riscvP riscv, Uns64 cycles) {
+    riscv->pendingCycles += cycles;
+}
+
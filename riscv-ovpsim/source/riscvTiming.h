@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2005-2023 Imperas Software Ltd., www.imperas.com
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+// VMI header files
+#include "vmi/vmiTypes.h"
+
+// model header files
+#include "riscvTypeRefs.h"
+
+//
+// This enumerates instruction latency classes used to compute approximate
+// cycle counts
+//
+typedef enum riscvLatencyClassE {
+    RVLC_INT,           // integer and other instructions
+    RVLC_MUL,           // integer multiply
+    RVLC_DIV,           // integer divide and remainder
+    RVLC_FP,            // floating point (except divide and square root)
+    RVLC_FDIV,          // floating point divide and square root
+    RVLC_LOAD,          // load, load-reserved and AMO
+    RVLC_STORE,         // store and store-conditional
+    RVLC_CSR,           // CSR access
+    RVLC_VECTOR,        // vector (per register of group)
+    RVLC_LAST           // KEEP LAST: for sizing
+} riscvLatencyClass;
+
+
+//
+// Allocate approximate timing structures for a hart if required
+//
+void riscvNewTiming(riscvP riscv);
+
+//
+// Free approximate timing structures for a hart
+//
+void riscvFreeTiming(riscvP riscv);
+
+//
+// Emit code to transfer pending cycles to the processor cycle count if
+// approximate cycles are modeled and this has not yet been done in this block
+//
+void riscvEmitTimingFlush(riscvP riscv);
+
+//
+// Emit code to account the latency of an instruction of the given class if
+// approximate timing is enabled (vregs is the number of registers by which
+// vector latency is scaled, or 0 if it is scaled by the active LMUL)
+//
+void riscvEmitTimingInstruction(
+    riscvP            riscv,
+    riscvLatencyClass class,
+    Uns32             vregs
+);
+
+//
+// Return cycles accounted but not yet added to the processor cycle count
+//
+Uns64 riscvGetPendingCycles(riscvP riscv);
+
+//
+// Add cycles from a runtime model (for example, cache miss penalty) to the
+// approximate cycle count
+//
+void riscvAddPendingCycles(riscvP riscv, Uns64 cycles);
+
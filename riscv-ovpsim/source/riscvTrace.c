@@ -0,0 +1,1265 @@
+/*
+ * Copyright (c) 2005-2023 Imperas Software Ltd., www.imperas.com
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Standard header files
+#include <stdio.h>
+#include <string.h>
+
+// host header files for shared-memory commit log
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Imperas header files
+#include "hostapi/impAlloc.h"
+
+// VMI header files
+#include "vmi/vmiCommand.h"
+#include "vmi/vmiMessage.h"
+#include "vmi/vmiMt.h"
+#include "vmi/vmiRt.h"
+
+// model header files
+#include "riscvCommitLogTypes.h"
+#include "riscvCSR.h"
+#include "riscvDecodeTypes.h"
+#include "riscvDisassemble.h"
+#include "riscvMessage.h"
+#include "riscvStructure.h"
+#include "riscvTrace.h"
+#include "riscvUtils.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+// TRACE FILE FORMAT
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// The trace file starts with a header (magic string, format version and XLEN)
+// followed by a stream of records. Each record starts with a tag byte whose
+// low two bits give the record kind. Multi-byte values are written as unsigned
+// LEB128 varints; signed values are zigzag-encoded first. Records are:
+//
+// RVBT_INSTR:  instruction executed. Tag bits 7:3 give the instruction size in
+//              bytes; if RVBT_JUMP is set, a signed PC delta from the expected
+//              sequential address follows. The instruction pattern follows as
+//              little-endian bytes.
+// RVBT_REGS:   X registers written by the previous instruction. A varint mask
+//              of written registers follows, then for each register a signed
+//              delta from the value previously recorded for that register.
+// RVBT_EXCEPT: exception or interrupt (RVBT_INT set) taken, with the varint
+//              exception code following.
+// RVBT_MEM:    load or store (RVBT_STORE set) by the current instruction. Tag
+//              bits 7:3 give the access size in bytes; a signed delta of the
+//              virtual address from the previous access address follows.
+//
+#define RVBT_MAGIC   "RVBT"
+#define RVBT_VERSION 1
+
+typedef enum riscvTraceTagE {
+    RVBT_INSTR    = 0x0,        // instruction executed
+    RVBT_REGS     = 0x1,        // registers written by previous instruction
+    RVBT_EXCEPT   = 0x2,        // exception taken
+    RVBT_MEM      = 0x3,        // memory access
+    RVBT_KIND     = 0x3,        // mask of record kind bits
+    RVBT_JUMP     = 0x4,        // (RVBT_INSTR) non-sequential PC
+    RVBT_INT      = 0x4,        // (RVBT_EXCEPT) asynchronous interrupt
+    RVBT_STORE    = 0x4,        // (RVBT_MEM) store
+    RVBT_SHIFT    = 3,          // (RVBT_INSTR, RVBT_MEM) shift to size
+} riscvTraceTag;
+
+//
+// Size of the per-hart record buffer, and maximum size of a single record
+// (register record with 31 registers, each a 10-byte varint)
+//
+#define TRACE_BUFFER_BYTES (1<<20)
+#define TRACE_RECORD_MAX   (1 + 5 + (31*10))
+
+//
+// Number of hash buckets for instruction descriptors (must be a power of two)
+//
+#define INSTR_HASH_SIZE 4096
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// TYPES
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// This describes one translated instruction (descriptors are allocated at
+// translation time and referenced by JIT code; an instruction translated again
+// with the same polymorphic key reuses its descriptor)
+//
+typedef struct riscvTraceInstrS {
+    riscvTraceInstrP next;          // next descriptor in hash bucket
+    Uns64            PC;            // instruction address
+    Uns64            instruction;   // instruction pattern
+    Uns32            key;           // polymorphic key at translation
+    Uns32            xMask;         // mask of X registers written
+    Uns32            fMask;         // mask of F registers written
+    Uns32            vMask;         // mask of V registers written
+    Uns8             bytes;         // instruction size
+} riscvTraceInstr;
+
+//
+// This holds instruction trace state for a hart (binary trace file and
+// shared-memory commit log, either of which may be absent)
+//
+typedef struct riscvTraceS {
+
+    // common state
+    riscvTraceInstrP  *instrs;      // instruction descriptors by hash bucket
+    riscvTraceInstrP   morph;       // descriptor being translated
+    riscvTraceInstrP   prev;        // last traced instruction (if retiring)
+    Uns64              prevPC;      // address of last traced instruction
+    Uns64              nextPC;      // expected address of next instruction
+
+    // binary trace file state
+    FILE              *file;        // trace file
+    Uns8              *buffer;      // record buffer
+    Uns32              used;        // bytes used in record buffer
+    Uns64              x[32];       // last recorded X register values
+    Uns64              lastVA;      // last recorded access address
+    Bool               memory;      // whether memory accesses are recorded
+
+    // commit log state
+    riscvCommitRing   *ring;        // shared-memory ring
+    riscvCommitRecord  pending;     // record for last traced instruction
+    Bool               pendingValid;// whether pending record is valid
+    Bool               intr;        // whether next record starts a handler
+    Uns32              intrCause;   // interrupt code for next record
+    Uns64              order;       // retirement index of next record
+} riscvTrace;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// TRACE WRITER
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Write buffered records to the trace file
+//
+static void flushBuffer(riscvTraceP trace) {
+
+    if(trace->used) {
+        fwrite(trace->buffer, 1, trace->used, trace->file);
+        trace->used = 0;
+    }
+}
+
+//
+// Ensure there is space in the buffer for a record of maximum size
+//
+inline static void reserveRecord(riscvTraceP trace) {
+    if((trace->used+TRACE_RECORD_MAX) > TRACE_BUFFER_BYTES) {
+        flushBuffer(trace);
+    }
+}
+
+//
+// Append a byte to the record buffer
+//
+inline static void putByte(riscvTraceP trace, Uns8 value) {
+    trace->buffer[trace->used++] = value;
+}
+
+//
+// Append an unsigned LEB128 varint to the record buffer
+//
+static void putVarint(riscvTraceP trace, Uns64 value) {
+
+    while(value>=0x80) {
+        putByte(trace, value | 0x80);
+        value >>= 7;
+    }
+
+    putByte(trace, value);
+}
+
+//
+// Append a zigzag-encoded signed varint to the record buffer
+//
+inline static void putSigned(riscvTraceP trace, Int64 value) {
+    putVarint(trace, ((Uns64)value<<1) ^ (value>>63));
+}
+
+//
+// Record X registers written by the last traced instruction
+//
+static void putRegisters(riscvP riscv, riscvTraceP trace) {
+
+    riscvTraceInstrP prev = trace->prev;
+    Uns32            mask = prev ? prev->xMask : 0;
+
+    if(mask) {
+
+        Uns32 i;
+
+        reserveRecord(trace);
+        putByte(trace, RVBT_REGS);
+        putVarint(trace, mask);
+
+        for(i=1; i<32; i++) {
+
+            if(mask & (1U<<i)) {
+
+                Uns64 value = riscv->x[i];
+
+                putSigned(trace, value-trace->x[i]);
+                trace->x[i] = value;
+            }
+        }
+    }
+}
+
+//
+// Record execution of an instruction in the binary trace file
+//
+static void putInstruction(
+    riscvTraceP      trace,
+    Uns64            thisPC,
+    riscvTraceInstrP instr
+) {
+    Int64 delta = thisPC-trace->nextPC;
+    Uns8  tag   = RVBT_INSTR | (instr->bytes<<RVBT_SHIFT);
+    Uns64 value = instr->instruction;
+    Uns32 i;
+
+    reserveRecord(trace);
+
+    if(delta) {
+        putByte(trace, tag | RVBT_JUMP);
+        putSigned(trace, delta);
+    } else {
+        putByte(trace, tag);
+    }
+
+    for(i=0; i<instr->bytes; i++) {
+        putByte(trace, value);
+        value >>= 8;
+    }
+}
+
+//
+// Record an exception in the binary trace file
+//
+static void putException(riscvTraceP trace, Uns32 ecode, Bool isInt) {
+
+    reserveRecord(trace);
+    putByte(trace, RVBT_EXCEPT | (isInt ? RVBT_INT : 0));
+    putVarint(trace, ecode);
+}
+
+//
+// Record a load or store in the binary trace file
+//
+static void putAccess(riscvTraceP trace, Uns64 VA, Uns32 tag) {
+
+    reserveRecord(trace);
+    putByte(trace, tag);
+    putSigned(trace, VA-trace->lastVA);
+
+    trace->lastVA = VA;
+}
+
+//
+// Write trace file header
+//
+static void putHeader(riscvP riscv, riscvTraceP trace) {
+
+    const char *magic = RVBT_MAGIC;
+
+    while(*magic) {
+        putByte(trace, *magic++);
+    }
+
+    putByte(trace, RVBT_VERSION);
+    putByte(trace, riscvGetXlenArch(riscv));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// TRACE DECODER
+////////////////////////////////////////////////////////////////////////////////
+
+#define DECODE_TRACE_NAME "decodeBinaryTrace"
+
+//
+// Read an unsigned LEB128 varint from the trace file, returning False at end
+// of file
+//
+static Bool getVarint(FILE *file, Uns64 *valueP) {
+
+    Uns64 value = 0;
+    Uns32 shift = 0;
+    Int32 byte;
+
+    do {
+
+        if((byte=getc(file))==EOF) {
+            return False;
+        }
+
+        value |= (Uns64)(byte & 0x7f) << shift;
+        shift += 7;
+
+    } while(byte & 0x80);
+
+    *valueP = value;
+
+    return True;
+}
+
+//
+// Read a zigzag-encoded signed varint from the trace file
+//
+static Bool getSigned(FILE *file, Int64 *valueP) {
+
+    Uns64 value;
+    Bool  ok = getVarint(file, &value);
+
+    *valueP = (value>>1) ^ -(value&1);
+
+    return ok;
+}
+
+//
+// Format a register value for display
+//
+static void formatValue(char *result, Uns64 value, Uns32 xlen) {
+    if(xlen==32) {
+        sprintf(result, "%08x", (Uns32)value);
+    } else {
+        sprintf(result, FMT_640Nx, value);
+    }
+}
+
+//
+// Print disassembly of all records in a binary trace file, using the
+// configuration of the given hart to decode instructions
+//
+static Bool decodeTrace(riscvP riscv, FILE *file) {
+
+    Uns64 x[32]  = {0};
+    Uns64 nextPC = 0;
+    Uns64 lastVA = 0;
+    char  header[sizeof(RVBT_MAGIC)+1];
+    Uns32 xlen;
+    Int32 tag;
+
+    // validate header
+    if(fread(header, 1, sizeof(header), file)!=sizeof(header)) {
+        return False;
+    } else if(memcmp(header, RVBT_MAGIC, sizeof(RVBT_MAGIC)-1)) {
+        return False;
+    } else if(header[sizeof(RVBT_MAGIC)-1]!=RVBT_VERSION) {
+        return False;
+    }
+
+    xlen = header[sizeof(RVBT_MAGIC)];
+
+    while((tag=getc(file))!=EOF) {
+
+        Uns32 kind = tag & RVBT_KIND;
+        char  valueString[32];
+
+        if(kind==RVBT_INSTR) {
+
+            Uns8  bytes       = tag>>RVBT_SHIFT;
+            Uns64 thisPC      = nextPC;
+            Uns64 instruction = 0;
+            Int64 delta       = 0;
+            Uns32 i;
+
+            if((tag & RVBT_JUMP) && !getSigned(file, &delta)) {
+                return False;
+            }
+
+            for(i=0; i<bytes; i++) {
+
+                Int32 byte = getc(file);
+
+                if(byte==EOF) {
+                    return False;
+                }
+
+                instruction |= (Uns64)byte << (i*8);
+            }
+
+            thisPC += delta;
+
+            if(xlen==32) {
+                thisPC = (Uns32)thisPC;
+            }
+
+            nextPC = thisPC+bytes;
+
+            formatValue(valueString, thisPC, xlen);
+
+            vmiPrintf(
+                "0x%s %s\n", valueString,
+                riscvDisassembleEncoding(
+                    riscv, thisPC, instruction, bytes, DSA_NORMAL
+                )
+            );
+
+        } else if(kind==RVBT_REGS) {
+
+            Uns64 mask;
+            Uns32 i;
+
+            if(!getVarint(file, &mask)) {
+                return False;
+            }
+
+            for(i=1; i<32; i++) {
+
+                Int64 delta;
+
+                if(!(mask & (1U<<i))) {
+                    // register not written
+                } else if(!getSigned(file, &delta)) {
+                    return False;
+                } else {
+                    x[i] += delta;
+                    formatValue(valueString, x[i], xlen);
+                    vmiPrintf("    x%-2u = 0x%s\n", i, valueString);
+                }
+            }
+
+        } else if(kind==RVBT_EXCEPT) {
+
+            Uns64 ecode;
+
+            if(!getVarint(file, &ecode)) {
+                return False;
+            }
+
+            vmiPrintf(
+                "    %s "FMT_Au"\n",
+                (tag & RVBT_INT) ? "interrupt" : "exception", ecode
+            );
+
+        } else {
+
+            Int64 delta;
+
+            if(!getSigned(file, &delta)) {
+                return False;
+            }
+
+            lastVA += delta;
+
+            if(xlen==32) {
+                lastVA = (Uns32)lastVA;
+            }
+
+            formatValue(valueString, lastVA, xlen);
+
+            vmiPrintf(
+                "    %s 0x%s (%u bytes)\n",
+                (tag & RVBT_STORE) ? "store" : "load",
+                valueString, tag>>RVBT_SHIFT
+            );
+        }
+    }
+
+    return True;
+}
+
+//
+// Handle decode of binary trace file
+//
+static VMIRT_COMMAND_PARSE_FN(decodeBinaryTrace) {
+
+    riscvP       riscv   = (riscvP)processor;
+    vmiArgValueP argFile = vmirtFindArgValue(argc, argv, "file");
+    const char  *name    = (argFile && argFile->isSet) ? argFile->u.string : 0;
+    FILE        *file    = name ? fopen(name, "rb") : 0;
+    Bool         ok;
+
+    if(!name) {
+
+        vmiPrintf("%s: -file <name>\n", DECODE_TRACE_NAME);
+
+        // error status
+        return NULL;
+
+    } else if(!file) {
+
+        vmiMessage("W", CPU_PREFIX"_BTOF",
+            "Unable to open binary trace file '%s'", name
+        );
+
+        // error status
+        return NULL;
+    }
+
+    ok = decodeTrace(riscv, file);
+    fclose(file);
+
+    if(!ok) {
+
+        vmiMessage("W", CPU_PREFIX"_BTIF",
+            "Binary trace file '%s' is invalid or truncated", name
+        );
+
+        // error status
+        return NULL;
+    }
+
+    return "1";
+}
+
+//
+// Add command for binary trace decode
+//
+static void addDecodeCommand(riscvP riscv) {
+
+    vmiCommandP cmd = vmirtAddCommandParse(
+        (vmiProcessorP)riscv,
+        DECODE_TRACE_NAME,
+        "print disassembly of a binary trace file",
+        decodeBinaryTrace,
+        VMI_CT_DEFAULT|VMI_CO_DIAG|VMI_CA_REPORT
+    );
+
+    const char *fileHelp = "binary trace file name";
+
+    vmirtAddArg(cmd, "file", fileHelp, VMI_CA_STRING, VMI_CAA_DEFAULT, False, 0);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// COMMIT LOG
+////////////////////////////////////////////////////////////////////////////////
+
+#if defined(_WIN32)
+
+//
+// Shared-memory commit log is not supported on this host
+//
+static riscvCommitRing *openRing(const char *name) {
+
+    vmiMessage("W", CPU_PREFIX"_CLNS",
+        "Commit log '%s' ignored (shared memory not supported on this host)",
+        name
+    );
+
+    return 0;
+}
+
+//
+// Unmap shared-memory commit log (not supported on this host)
+//
+static void closeRing(riscvCommitRing *ring) {
+}
+
+//
+// Wait for space in the shared-memory commit log (not supported on this host)
+//
+static void waitRing(void) {
+}
+
+#else
+
+//
+// Create and map the shared-memory commit log with the given name
+//
+static riscvCommitRing *openRing(const char *name) {
+
+    riscvCommitRing *ring = 0;
+    Int32            fd   = shm_open(name, O_CREAT|O_RDWR|O_TRUNC, 0600);
+
+    if(fd<0) {
+        // shared memory object not created
+    } else if(ftruncate(fd, sizeof(*ring))) {
+        close(fd);
+    } else {
+
+        void *map = mmap(
+            0, sizeof(*ring), PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0
+        );
+
+        close(fd);
+
+        if(map!=MAP_FAILED) {
+            ring = map;
+        }
+    }
+
+    if(!ring) {
+        vmiMessage("W", CPU_PREFIX"_CLOF",
+            "Unable to create commit log shared memory '%s'", name
+        );
+    }
+
+    return ring;
+}
+
+//
+// Unmap shared-memory commit log (the object remains available to the
+// consumer until it is unlinked)
+//
+static void closeRing(riscvCommitRing *ring) {
+    munmap(ring, sizeof(*ring));
+}
+
+//
+// Wait for space in the shared-memory commit log
+//
+static void waitRing(void) {
+    sched_yield();
+}
+
+#endif
+
+//
+// Initialize the shared-memory commit log header (the magic string is written
+// last so that a consumer can poll for it)
+//
+static void initRing(riscvP riscv, riscvCommitRing *ring) {
+
+    ring->version     = RVCL_VERSION;
+    ring->slots       = RVCL_SLOTS;
+    ring->recordBytes = sizeof(riscvCommitRecord);
+    ring->xlen        = riscvGetXlenArch(riscv);
+    ring->head        = 0;
+    ring->dropped     = 0;
+    ring->tail        = 0;
+    ring->attached    = 0;
+
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    memcpy(ring->magic, RVCL_MAGIC, sizeof(ring->magic));
+}
+
+//
+// Is the shared-memory commit log full?
+//
+inline static Bool ringFull(riscvCommitRing *ring, Uns64 head) {
+    return (head-__atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE)) >= RVCL_SLOTS;
+}
+
+//
+// Is a consumer attached to the shared-memory commit log?
+//
+inline static Bool ringAttached(riscvCommitRing *ring) {
+    return __atomic_load_n(&ring->attached, __ATOMIC_ACQUIRE);
+}
+
+//
+// Publish a record to the shared-memory commit log. While the ring is full
+// and a consumer is attached, wait for the consumer to free a slot; if no
+// consumer is attached the record is discarded, so that a hart without a
+// consumer does not stall
+//
+static void publishRecord(riscvTraceP trace, riscvCommitRecord *record) {
+
+    riscvCommitRing *ring = trace->ring;
+    Uns64            head = ring->head;
+
+    while(ringFull(ring, head) && ringAttached(ring)) {
+        waitRing();
+    }
+
+    if(ringFull(ring, head)) {
+
+        // no consumer attached
+        __atomic_store_n(&ring->dropped, ring->dropped+1, __ATOMIC_RELEASE);
+
+    } else {
+
+        ring->records[head & (RVCL_SLOTS-1)] = *record;
+        __atomic_store_n(&ring->head, head+1, __ATOMIC_RELEASE);
+    }
+}
+
+//
+// Start the commit record for an instruction
+//
+static void startRecord(
+    riscvP           riscv,
+    riscvTraceP      trace,
+    Uns64            thisPC,
+    riscvTraceInstrP instr
+) {
+    riscvCommitRecord *record = &trace->pending;
+
+    memset(record, 0, sizeof(*record));
+
+    record->order = trace->order++;
+    record->pc    = thisPC;
+    record->insn  = instr->instruction;
+    record->bytes = instr->bytes;
+    record->mode  = getCurrentMode5(riscv);
+
+    // first instruction of an interrupt handler
+    if(trace->intr) {
+        record->flags |= RVCL_INTR;
+        record->cause  = trace->intrCause;
+        trace->intr    = False;
+    }
+
+    trace->pendingValid = True;
+}
+
+//
+// Return index of the lowest register in a nonzero mask
+//
+inline static Uns32 lowestReg(Uns32 mask) {
+    return __builtin_ctz(mask);
+}
+
+//
+// Fill results of the last traced instruction in its commit record
+//
+static void fillRecordResults(
+    riscvP           riscv,
+    riscvTraceP      trace,
+    riscvTraceInstrP instr
+) {
+    riscvCommitRecord *record = &trace->pending;
+
+    record->xMask = instr->xMask;
+
+    if(instr->xMask) {
+        record->flags  |= RVCL_RD;
+        record->rdAddr  = lowestReg(instr->xMask);
+        record->rdData  = riscv->x[record->rdAddr];
+    }
+
+    if(instr->fMask) {
+        record->flags  |= RVCL_FD;
+        record->fdAddr  = lowestReg(instr->fMask);
+        record->fdData  = riscv->f[record->fdAddr];
+    }
+
+    record->vMask = instr->vMask;
+
+    // only the low 64 bits of the lowest vector register are recorded
+    if(instr->vMask) {
+
+        Uns32 VLEN  = riscv->configInfo.VLEN;
+        Uns32 bytes = (VLEN<64) ? VLEN/8 : 8;
+
+        record->flags  |= RVCL_VD;
+        record->vdAddr  = lowestReg(instr->vMask);
+        memcpy(&record->vdData, &riscv->v[record->vdAddr*VLEN/32], bytes);
+    }
+}
+
+//
+// Fill the CSR written by the current instruction in its commit record
+//
+static void fillRecordCSR(riscvTraceP trace, Uns32 csrNum, Uns64 value) {
+
+    riscvCommitRecord *record = &trace->pending;
+
+    if(trace->pendingValid) {
+        record->flags   |= RVCL_CSR;
+        record->csrAddr  = csrNum;
+        record->csrData  = value;
+    }
+}
+
+//
+// Fill a load or store by the current instruction in its commit record (only
+// the first access is recorded, except that the store of an atomic
+// read-modify-write is indicated with its load)
+//
+static void fillRecordAccess(
+    riscvTraceP trace,
+    Uns64       VA,
+    Uns32       bytes,
+    Bool        isStore
+) {
+    riscvCommitRecord *record = &trace->pending;
+    Uns8               flag   = isStore ? RVCL_STORE : RVCL_LOAD;
+
+    if(!trace->pendingValid) {
+
+        // no current instruction
+
+    } else if(!(record->flags & (RVCL_LOAD|RVCL_STORE))) {
+
+        record->flags    |= flag;
+        record->memAddr   = VA;
+        record->memBytes  = bytes;
+
+    } else if((record->memAddr==VA) && (record->memBytes==bytes)) {
+
+        record->flags |= flag;
+    }
+}
+
+//
+// Publish the commit record for the last traced instruction, now that the
+// address of the next instruction is known
+//
+static void publishPending(riscvTraceP trace, Uns64 nextPC) {
+
+    if(trace->pendingValid) {
+        trace->pending.nextPC = nextPC;
+        trace->pendingValid   = False;
+        publishRecord(trace, &trace->pending);
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// INSTRUCTION RETIREMENT
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Capture results of the last traced instruction, which has retired
+//
+static void captureResults(riscvP riscv, riscvTraceP trace) {
+
+    riscvTraceInstrP prev = trace->prev;
+
+    if(prev) {
+
+        if(trace->file) {
+            putRegisters(riscv, trace);
+        }
+
+        if(trace->ring) {
+            fillRecordResults(riscv, trace, prev);
+        }
+
+        trace->prev = 0;
+    }
+}
+
+//
+// Record execution of an instruction (called from JIT code at the start of
+// each traced instruction)
+//
+static void traceInstruction(
+    riscvP           riscv,
+    Uns64            thisPC,
+    riscvTraceInstrP instr
+) {
+    riscvTraceP trace = riscv->trace;
+
+    // previous instruction has retired, so its results are known
+    captureResults(riscv, trace);
+
+    if(trace->file) {
+        putInstruction(trace, thisPC, instr);
+    }
+
+    if(trace->ring) {
+        publishPending(trace, thisPC);
+        startRecord(riscv, trace, thisPC, instr);
+    }
+
+    // results are recorded when the instruction retires
+    trace->prev   = instr;
+    trace->prevPC = thisPC;
+    trace->nextPC = thisPC+instr->bytes;
+}
+
+//
+// Record a load or store (called from JIT code before each access)
+//
+static void traceAccess(
+    riscvP riscv,
+    Uns64  base,
+    Uns64  offset,
+    Uns32  tag,
+    Bool   is32
+) {
+    riscvTraceP trace = riscv->trace;
+    Uns64       VA    = base+offset;
+
+    if(is32) {
+        VA = (Uns32)VA;
+    }
+
+    if(trace->memory) {
+        putAccess(trace, VA, tag);
+    }
+
+    if(trace->ring) {
+        fillRecordAccess(trace, VA, tag>>RVBT_SHIFT, (tag & RVBT_STORE)!=0);
+    }
+}
+
+//
+// Record the value of a CSR written by the current instruction, held in a
+// field in the processor structure (called from JIT code after the write)
+//
+static void traceCSRField(
+    riscvP      riscv,
+    Uns32       csrNum,
+    const void *field,
+    Bool        is64
+) {
+    Uns64 value = is64 ? *(const Uns64*)field : *(const Uns32*)field;
+
+    fillRecordCSR(riscv->trace, csrNum, value);
+}
+
+//
+// Record the value of a CSR written by the current instruction, read using
+// its read callback (called from JIT code after the write)
+//
+static void traceCSRRead(riscvP riscv, riscvCSRAttrsCP attrs) {
+
+    Uns64 value = 0;
+
+    if(riscvReadCSR(attrs, riscv, &value)) {
+        fillRecordCSR(riscv->trace, attrs->csrNum, value);
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// PUBLIC INTERFACE
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Open the binary trace file for a hart if required
+//
+static FILE *openTraceFile(riscvP riscv) {
+
+    const char *name = riscv->binaryTraceFile;
+    FILE       *file = 0;
+
+    if(name && name[0]) {
+
+        const char *hart = vmirtProcessorName((vmiProcessorP)riscv);
+        char        fileName[1024];
+
+        // each hart writes a separate file, suffixed with its processor name
+        // (which includes the names of any containing clusters, so that harts
+        // in different clusters with the same hart index are distinguished)
+        snprintf(fileName, sizeof(fileName), "%s.%s", name, hart);
+
+        if(!(file=fopen(fileName, "wb"))) {
+            vmiMessage("W", CPU_PREFIX"_BTOF",
+                "Unable to open binary trace file '%s'", fileName
+            );
+        }
+    }
+
+    return file;
+}
+
+//
+// Open the shared-memory commit log for a hart if required
+//
+static riscvCommitRing *openCommitLog(riscvP riscv) {
+
+    const char      *name = riscv->commitLogName;
+    riscvCommitRing *ring = 0;
+
+    if(name && name[0]) {
+
+        const char *hart = vmirtProcessorName((vmiProcessorP)riscv);
+        char        ringName[1024];
+
+        // each hart publishes a separate ring, suffixed with its processor
+        // name (as for the binary trace file)
+        snprintf(ringName, sizeof(ringName), "%s.%s", name, hart);
+
+        if((ring=openRing(ringName))) {
+            initRing(riscv, ring);
+        }
+    }
+
+    return ring;
+}
+
+//
+// Allocate instruction trace structures and commands for a hart
+//
+void riscvNewTrace(riscvP riscv) {
+
+    FILE            *file = openTraceFile(riscv);
+    riscvCommitRing *ring = openCommitLog(riscv);
+
+    // trace decode is available whether or not trace is enabled
+    addDecodeCommand(riscv);
+
+    if(file || ring) {
+
+        riscvTraceP trace = riscv->trace = STYPE_CALLOC(riscvTrace);
+
+        trace->ring   = ring;
+        trace->instrs = STYPE_CALLOC_N(riscvTraceInstrP, INSTR_HASH_SIZE);
+
+        if(file) {
+            trace->memory = riscv->binTraceMem;
+            trace->file   = file;
+            trace->buffer = STYPE_CALLOC_N(Uns8, TRACE_BUFFER_BYTES);
+            putHeader(riscv, trace);
+        }
+    }
+}
+
+//
+// Flush and free instruction trace structures for a hart
+//
+void riscvFreeTrace(riscvP riscv) {
+
+    riscvTraceP trace = riscv->trace;
+
+    if(trace) {
+
+        Uns32 i;
+
+        // record results of final instruction
+        captureResults(riscv, trace);
+
+        if(trace->file) {
+            flushBuffer(trace);
+            fclose(trace->file);
+            STYPE_FREE(trace->buffer);
+        }
+
+        if(trace->ring) {
+            publishPending(trace, vmirtGetPC((vmiProcessorP)riscv));
+            closeRing(trace->ring);
+        }
+
+        for(i=0; i<INSTR_HASH_SIZE; i++) {
+
+            riscvTraceInstrP instr;
+
+            while((instr=trace->instrs[i])) {
+                trace->instrs[i] = instr->next;
+                STYPE_FREE(instr);
+            }
+        }
+
+        STYPE_FREE(trace->instrs);
+        STYPE_FREE(trace);
+        riscv->trace = 0;
+    }
+}
+
+//
+// Return the descriptor for an instruction at the given address, creating it
+// if required (an instruction translated again after a dictionary flush uses
+// the same descriptor, so that descriptors are not allocated again for each
+// translation). The polymorphic key is part of the match because the vector
+// registers written by an instruction depend on vtype.
+//
+static riscvTraceInstrP getTraceInstr(
+    riscvTraceP trace,
+    Uns64       PC,
+    Uns64       instruction,
+    Uns32       bytes,
+    Uns32       key
+) {
+    riscvTraceInstrP *bucketP = &trace->instrs[(PC>>1) & (INSTR_HASH_SIZE-1)];
+    riscvTraceInstrP  instr;
+
+    for(instr=*bucketP; instr; instr=instr->next) {
+        if(
+            (instr->PC==PC) && (instr->instruction==instruction) &&
+            (instr->bytes==bytes) && (instr->key==key)
+        ) {
+            return instr;
+        }
+    }
+
+    // create new descriptor
+    instr              = STYPE_CALLOC(riscvTraceInstr);
+    instr->next        = *bucketP;
+    instr->PC          = PC;
+    instr->instruction = instruction;
+    instr->bytes       = bytes;
+    instr->key         = key;
+    *bucketP           = instr;
+
+    return instr;
+}
+
+//
+// Emit code to record execution of the given instruction if instruction trace
+// is enabled
+//
+void riscvEmitTraceInstruction(
+    riscvP riscv,
+    Uns64  instruction,
+    Uns32  bytes,
+    Uns32  key
+) {
+    riscvTraceP trace = riscv->trace;
+
+    if(trace) {
+
+        Uns64            PC    = vmirtGetPC((vmiProcessorP)riscv);
+        riscvTraceInstrP instr = getTraceInstr(
+            trace, PC, instruction, bytes, key
+        );
+
+        trace->morph = instr;
+
+        vmimtArgProcessor();
+        vmimtArgSimPC(64);
+        vmimtArgNatAddress(instr);
+        vmimtCall((vmiCallFn)traceInstruction);
+    }
+}
+
+//
+// Complete translation of an instruction recorded in the instruction trace
+// (the masks of written registers are known only once it has been translated)
+//
+void riscvEmitTraceInstructionEnd(riscvP riscv) {
+
+    riscvTraceP trace = riscv->trace;
+
+    if(trace && trace->morph) {
+        trace->morph->xMask = riscv->writtenXMask;
+        trace->morph->fMask = riscv->writtenFMask;
+        trace->morph->vMask = riscv->writtenVMask;
+        trace->morph        = 0;
+    }
+}
+
+//
+// Emit code to record the value of a CSR written by the instruction being
+// translated in the commit log if required. If the CSR value is held in a field
+// in the processor structure it is read directly from that field; otherwise it
+// is read using the CSR read callback.
+//
+void riscvEmitTraceCSRWrite(
+    riscvP          riscv,
+    riscvCSRAttrsCP attrs,
+    const void     *field,
+    Bool            is64
+) {
+    riscvTraceP trace = riscv->trace;
+
+    if(!trace || !trace->ring) {
+
+        // no action
+
+    } else if(field) {
+
+        vmimtArgProcessor();
+        vmimtArgUns32(attrs->csrNum);
+        vmimtArgNatAddress(field);
+        vmimtArgUns32(is64);
+        vmimtCall((vmiCallFn)traceCSRField);
+
+    } else {
+
+        vmimtArgProcessor();
+        vmimtArgNatAddress(attrs);
+        vmimtCall((vmiCallFn)traceCSRRead);
+    }
+}
+
+//
+// Record an exception or interrupt in the instruction trace if enabled (the
+// last traced instruction retired unless it is the instruction taking a
+// synchronous exception)
+//
+void riscvTraceException(riscvP riscv, Uns32 ecode, Bool isInt, Uns64 EPC) {
+
+    riscvTraceP trace = riscv->trace;
+
+    if(!trace) {
+
+        // no action
+
+    } else if(!isInt && trace->prev && (trace->prevPC==EPC)) {
+
+        // last traced instruction did not retire
+        trace->prev = 0;
+
+        if(trace->ring && trace->pendingValid) {
+            trace->pending.flags |= RVCL_TRAP;
+            trace->pending.cause  = ecode;
+        }
+
+    } else {
+
+        // last traced instruction retired
+        captureResults(riscv, trace);
+
+        // interrupt is indicated on the first handler instruction
+        if(isInt) {
+            trace->intr      = True;
+            trace->intrCause = ecode;
+        }
+    }
+
+    if(trace && trace->file) {
+        putException(trace, ecode, isInt);
+    }
+}
+
+//
+// Are loads and stores recorded (by binary trace of memory accesses or the
+// commit log)?
+//
+Bool riscvTraceAccesses(riscvP riscv) {
+
+    riscvTraceP trace = riscv->trace;
+
+    return trace && (trace->memory || trace->ring);
+}
+
+//
+// Emit code to record a load or store with address ra+offset if binary trace
+// of memory accesses or the commit log is enabled
+//
+void riscvEmitTraceAccess(
+    riscvP riscv,
+    vmiReg ra,
+    Uns64  offset,
+    Uns32  memBits,
+    Bool   isStore
+) {
+    if(riscvTraceAccesses(riscv)) {
+
+        Uns32 raBits = riscvGetXlenMode(riscv);
+        Uns32 tag    = RVBT_MEM | ((memBits/8)<<RVBT_SHIFT);
+
+        if(isStore) {
+            tag |= RVBT_STORE;
+        }
+
+        vmimtArgProcessor();
+
+        if(VMI_ISNOREG(ra)) {
+            vmimtArgUns64(0);
+        } else {
+            vmimtArgRegSimAddress(raBits, ra);
+        }
+
+        vmimtArgUns64(offset);
+        vmimtArgUns32(tag);
+        vmimtArgUns32(raBits==32);
+        vmimtCall((vmiCallFn)traceAccess);
+    }
+}
+
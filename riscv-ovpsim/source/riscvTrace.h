@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2005-2023 Imperas Software Ltd., www.imperas.com
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+// VMI header files
+#include "vmi/vmiTypes.h"
+
+// model header files
+#include "riscvTypeRefs.h"
+
+
+//
+// Allocate instruction trace structures and commands for a hart
+//
+void riscvNewTrace(riscvP riscv);
+
+//
+// Flush and free instruction trace structures for a hart
+//
+void riscvFreeTrace(riscvP riscv);
+
+//
+// Emit code to record execution of the given instruction if instruction trace
+// is enabled (key is the polymorphic key for the instruction)
+//
+void riscvEmitTraceInstruction(
+    riscvP riscv,
+    Uns64  instruction,
+    Uns32  bytes,
+    Uns32  key
+);
+
+//
+// Complete translation of an instruction recorded in the instruction trace
+//
+void riscvEmitTraceInstructionEnd(riscvP riscv);
+
+//
+// Emit code to record the value of a CSR written by the instruction being
+// translated in the commit log if required (field is the processor structure
+// field holding the CSR value, or null if the value must be read using the CSR
+// read callback)
+//
+void riscvEmitTraceCSRWrite(
+    riscvP          riscv,
+    riscvCSRAttrsCP attrs,
+    const void     *field,
+    Bool            is64
+);
+
+//
+// Record an exception or interrupt in the instruction trace if enabled
+//
+void riscvTraceException(riscvP riscv, Uns32 ecode, Bool isInt, Uns64 EPC);
+
+//
+// Are loads and stores recorded (by binary trace of memory accesses or the
+// commit log)?
+//
+Bool riscvTraceAccesses(riscvP riscv);
+
+//
+// Emit code to record a load or store with address ra+offset if binary trace
+// of memory accesses or the commit log is enabled
+//
+void riscvEmitTraceAccess(
+    riscvP riscv,
+    vmiReg ra,
+    Uns64  offset,
+    Uns32  memBits,
+    Bool   isStore
+);
+
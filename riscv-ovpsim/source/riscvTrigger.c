@@ -181,7 +181,7 @@ riscvArchitecture riscvGetCurrentTriggers(riscvP riscv) {
 
             // flush dictionaries if required
             if(doFlush) {
-                vmirtFlushAllDicts((vmiProcessorP)riscv);
+                riscvFlushAllDicts(riscv, RVFC_TRIGGER);
             }
         }
     }
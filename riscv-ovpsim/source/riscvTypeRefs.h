@@ -23,10 +23,17 @@
 #include "hostapi/typeMacros.h"
 
 DEFINE_S (riscv);
+DEFINE_S (riscvAccessSite);
 DEFINE_S (riscvAIA);
 DEFINE_S (riscvBasicIntState);
+DEFINE_S (riscvBlockEntry);
 DEFINE_S (riscvBlockState);
+DEFINE_S (riscvBranchModel);
+DEFINE_S (riscvBranchSite);
+DEFINE_S (riscvBTBEntry);
 DEFINE_S (riscvBusPort);
+DEFINE_S (riscvCache);
+DEFINE_S (riscvCacheModel);
 DEFINE_U (riscvCLICIntState);
 DEFINE_S (riscvCLICOutState);
 DEFINE_S (riscvCSRRemap);
@@ -42,17 +49,28 @@ DEFINE_CS(riscvExtInstrAttrs);
 DEFINE_S (riscvExtInstrInfo);
 DEFINE_CS(riscvExtMorphAttr);
 DEFINE_S (riscvExtMorphState);
+DEFINE_S (riscvFetchBuffer);
+DEFINE_S (riscvFuseInfo);
 DEFINE_S (riscvInstrInfo);
+DEFINE_S (riscvMemProfile);
+DEFINE_S (riscvMixEntry);
 DEFINE_S (riscvNetPort);
 DEFINE_CS(riscvMorphAttr);
+DEFINE_S (riscvMorphStats);
 DEFINE_S (riscvMorphState);
+DEFINE_S (riscvPageEntry);
 DEFINE_S (riscvParamValues);
 DEFINE_S (riscvPendEnab);
+DEFINE_S (riscvProfile);
 DEFINE_CS(riscvPMARegion);
 DEFINE_S (riscvRegList);
 DEFINE_S (riscvTData1UP);
 DEFINE_S (riscvTData3UP);
 DEFINE_S (riscvTLB);
+DEFINE_S (riscvTageEntry);
 DEFINE_S (riscvTLBVCxt);
+DEFINE_S (riscvTiming);
+DEFINE_S (riscvTrace);
+DEFINE_S (riscvTraceInstr);
 DEFINE_S (riscvTrigger);
 
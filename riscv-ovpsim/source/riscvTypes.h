@@ -55,6 +55,21 @@ typedef enum riscvCMOTypeS {
     RISCV_CMO_ZERO,     // cbo.zero active
 } riscvCMOType;
 
+//
+// Model performance monitor events (selected by mhpmevent when cache or
+// branch prediction models are enabled)
+//
+typedef enum riscvHPMEventE {
+    RVHE_NONE,          // no event
+    RVHE_ICACHE_ACCESS, // instruction cache access
+    RVHE_ICACHE_MISS,   // instruction cache miss
+    RVHE_DCACHE_ACCESS, // data cache access
+    RVHE_DCACHE_MISS,   // data cache miss
+    RVHE_BRANCH,        // branch or jump executed
+    RVHE_BRANCH_MISS,   // branch or jump mispredicted
+    RVHE_LAST           // KEEP LAST: for sizing
+} riscvHPMEvent;
+
 //
 // Processor hart reasons (bitmask)
 //
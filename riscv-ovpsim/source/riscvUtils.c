@@ -32,6 +32,8 @@
 #include "riscvFunctions.h"
 #include "riscvMessage.h"
 #include "riscvMode.h"
+#include "riscvMorph.h"
+#include "riscvProfile.h"
 #include "riscvStructure.h"
 #include "riscvTrigger.h"
 #include "riscvUtils.h"
@@ -130,6 +132,11 @@ void riscvSetCurrentArch(riscvP riscv) {
         } else if(!(RD_CSRC(riscv, vsstatus) & WM_mstatus_VS)) {
             arch &= ~ISA_V;
         }
+
+        // allocate vector registers when vector state is first enabled
+        if(arch & ISA_V) {
+            riscvAllocVector(riscv);
+        }
     }
 
     // handle big endian access if required
@@ -218,11 +225,21 @@ void riscvUpdateDynamicBF16(riscvP riscv, Bool newBF16) {
         // flush dictionaries if dynamic BF16 check is required
         if(!riscv->dynamicBF16) {
             riscv->dynamicBF16 = True;
-            vmirtFlushAllDicts((vmiProcessorP)riscv);
+            riscvFlushAllDicts(riscv, RVFC_BF16);
         }
     }
 }
 
+//
+// Flush all code dictionaries, recording the cause
+//
+void riscvFlushAllDicts(riscvP riscv, riscvFlushCause cause) {
+
+    riscvProfileFlush(riscv, cause);
+
+    vmirtFlushAllDicts((vmiProcessorP)riscv);
+}
+
 //
 // Return XLEN for the given riscvArchitecture
 //
@@ -847,6 +864,9 @@ const char *riscvGetVRegName(riscvP riscv, Uns32 index) {
 //
 vmiReg riscvGetVReg(riscvP riscv, Uns32 index) {
 
+    // translated code must refer to registers allocated for this hart
+    riscvAllocVector(riscv);
+
     void *value = &riscv->v[index*riscv->configInfo.VLEN/32];
 
     return vmimtGetExtReg((vmiProcessorP)riscv, value);
@@ -1046,7 +1066,12 @@ RISCV_SET_TMODE_FN(riscvSetTMode) {
 
         riscv->useTMode = True;
 
-        vmirtFlushAllDicts((vmiProcessorP)riscv);
+        riscvFlushAllDicts(riscv, RVFC_TMODE);
+    }
+
+    // record polymorphic key change
+    if(enable != !!(riscv->pmKey & PMK_TRANSACTION)) {
+        riscvProfilePMKeyChange(riscv);
     }
 
     // enable mode using polymorphic key
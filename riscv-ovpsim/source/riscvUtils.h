@@ -25,6 +25,7 @@
 // model header files
 #include "riscvMode.h"
 #include "riscvModelCallbacks.h"
+#include "riscvProfile.h"
 #include "riscvTypes.h"
 #include "riscvTypeRefs.h"
 #include "riscvVariant.h"
@@ -45,6 +46,11 @@ void riscvSetCurrentArch(riscvP riscv);
 //
 void riscvUpdateDynamicBF16(riscvP riscv, Bool newBF16);
 
+//
+// Flush all code dictionaries, recording the cause
+//
+void riscvFlushAllDicts(riscvP riscv, riscvFlushCause cause);
+
 //
 // Return the configured XLEN (may not be the current XLEN if dynamic update
 // of XLEN is allowed)
@@ -0,0 +1,1793 @@
+/*
+ * Copyright (c) 2005-2023 Imperas Software Ltd., www.imperas.com
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Standard header files
+#include <fenv.h>
+#include <math.h>
+#include <string.h>
+
+// VMI header files
+#include "vmi/vmiRt.h"
+
+// model header files
+#include "riscvStructure.h"
+#include "riscvVectorKernels.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+// REGISTER ACCESS UTILITIES
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Value returned by riscvVKFirst if no bit is found
+//
+#define VK_NONE ((Uns64)-1)
+
+//
+// Return host pointer to bytes of the indexed vector register
+//
+inline static Uns8 *getVRegBytes(riscvP riscv, Uns32 index) {
+    return (Uns8 *)&riscv->v[index*riscv->configInfo.VLEN/32];
+}
+
+//
+// Return host pointer to 64-bit words of the indexed vector register
+//
+inline static Uns64 *getVRegWords(riscvP riscv, Uns32 index) {
+    return (Uns64 *)getVRegBytes(riscv, index);
+}
+
+//
+// Return index of the first mask word of range [vstart,vl)
+//
+inline static Uns32 getWordStart(Uns32 vstart) {
+    return vstart/64;
+}
+
+//
+// Return index one beyond the last mask word of range [vstart,vl)
+//
+inline static Uns32 getWordEnd(Uns32 vstart, Uns32 vl) {
+    return (vstart<vl) ? (vl+63)/64 : 0;
+}
+
+//
+// Return mask of bits in word w below the given element index
+//
+static Uns64 getBitsBefore(Uns64 index, Uns32 w) {
+
+    Uns64 lo = (Uns64)w*64;
+
+    if(index<=lo) {
+        return 0;
+    } else if(index>=lo+64) {
+        return -1;
+    } else {
+        return ((Uns64)1<<(index-lo)) - 1;
+    }
+}
+
+//
+// Return mask of bits in word w within the range [vstart,vl)
+//
+inline static Uns64 getRangeMask(Uns32 w, Uns32 vstart, Uns32 vl) {
+    return getBitsBefore(vl, w) & ~getBitsBefore(vstart, w);
+}
+
+//
+// Return words of mask register v0 if the operation is masked, or NULL if not
+//
+inline static Uns64 *getMaskWords(riscvP riscv, riscvVKFlags flags) {
+    return (flags & RVVK_MASKED) ? getVRegWords(riscv, 0) : 0;
+}
+
+//
+// Return mask of elements in word w within the range [vstart,vl) that are
+// selected by mask register words vm (if any)
+//
+inline static Uns64 getActiveMask(Uns64 *vm, Uns32 w, Uns32 vstart, Uns32 vl) {
+    return getRangeMask(w, vstart, vl) & (vm ? vm[w] : -1);
+}
+
+//
+// Return the indexed element of the given width in a register group
+//
+static Uns64 getElement(Uns8 *base, Uns32 EEW, Uns64 index) {
+
+    switch(EEW) {
+        case 8:  return ((Uns8  *)base)[index];
+        case 16: return ((Uns16 *)base)[index];
+        case 32: return ((Uns32 *)base)[index];
+        default: return ((Uns64 *)base)[index];
+    }
+}
+
+//
+// Return host pointer to the indexed element of the given width
+//
+inline static Uns8 *getElementPtr(Uns8 *base, Uns32 EEW, Uns64 index) {
+    return base + index*(EEW/8);
+}
+
+//
+// Set the indexed element of the given width in a register group
+//
+static void setElement(Uns8 *base, Uns32 EEW, Uns64 index, Uns64 value) {
+
+    switch(EEW) {
+        case 8:  ((Uns8  *)base)[index] = value; break;
+        case 16: ((Uns16 *)base)[index] = value; break;
+        case 32: ((Uns32 *)base)[index] = value; break;
+        default: ((Uns64 *)base)[index] = value; break;
+    }
+}
+
+//
+// This is an iterator over elements in a range selected by a mask register
+//
+typedef struct activeIterS {
+    Uns64 *vm;      // mask register words (or NULL if unmasked)
+    Uns32  start;   // first element of range
+    Uns32  end;     // element one beyond end of range
+    Uns32  w;       // current mask word
+    Uns32  wEnd;    // mask word one beyond end of range
+    Uns64  bits;    // remaining active elements in current word
+} activeIter, *activeIterP;
+
+//
+// Start iteration over elements in range [start,end) selected by vm
+//
+static void startActive(activeIterP it, Uns64 *vm, Uns32 start, Uns32 end) {
+
+    it->vm    = vm;
+    it->start = start;
+    it->end   = end;
+    it->w     = getWordStart(start);
+    it->wEnd  = getWordEnd(start, end);
+    it->bits  = (it->w<it->wEnd) ? getActiveMask(vm, it->w, start, end) : 0;
+}
+
+//
+// Return the next active element index in *indexP, or False if there are none
+//
+static Bool nextActive(activeIterP it, Uns32 *indexP) {
+
+    while(!it->bits) {
+
+        if(++it->w>=it->wEnd) {
+            return False;
+        }
+
+        it->bits = getActiveMask(it->vm, it->w, it->start, it->end);
+    }
+
+    *indexP   = it->w*64 + __builtin_ctzll(it->bits);
+    it->bits &= it->bits-1;
+
+    return True;
+}
+
+//
+// Remove the lowest run of consecutive set bits from *bitsP, returning the
+// index of its first bit and setting its length in *runP
+//
+static Uns32 takeRun(Uns64 *bitsP, Uns32 *runP) {
+
+    Uns64 bits = *bitsP;
+    Uns32 lo   = __builtin_ctzll(bits);
+    Uns64 rest = ~(bits>>lo);
+    Uns32 run  = rest ? __builtin_ctzll(rest) : 64-lo;
+
+    *bitsP = (lo+run<64) ? (bits & ~(((Uns64)1<<(lo+run))-1)) : 0;
+    *runP  = run;
+
+    return lo;
+}
+
+//
+// Set masked-off elements in range [vstart,vl) to all-ones if required, one
+// run of consecutive masked-off elements at a time
+//
+static void fillMaskedOff(
+    riscvP       riscv,
+    Uns8        *vdB,
+    Uns32        SEW,
+    riscvVKFlags flags,
+    Uns32        vstart,
+    Uns32        vl
+) {
+    if(flags & RVVK_VMA1) {
+
+        Uns64 *vm  = getMaskWords(riscv, flags);
+        Uns32  end = getWordEnd(vstart, vl);
+        Uns32  w;
+
+        for(w=getWordStart(vstart); w<end; w++) {
+
+            Uns64 update = getRangeMask(w, vstart, vl) & ~vm[w];
+
+            while(update) {
+
+                Uns32 run;
+                Uns32 first = w*64 + takeRun(&update, &run);
+
+                memset(getElementPtr(vdB, SEW, first), -1, run*(SEW/8));
+            }
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// MASK KERNELS
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Return count of active set bits in mask register vs2 (vcpop.m)
+//
+Uns64 riscvVKCPop(
+    riscvP       riscv,
+    Uns32        vs2,
+    riscvVKFlags flags,
+    Uns32        vstart,
+    Uns32        vl
+) {
+    Uns64 *vs2W   = getVRegWords(riscv, vs2);
+    Uns64 *vm     = getMaskWords(riscv, flags);
+    Uns32  end    = getWordEnd(vstart, vl);
+    Uns64  result = 0;
+    Uns32  w;
+
+    for(w=getWordStart(vstart); w<end; w++) {
+        result += __builtin_popcountll(
+            vs2W[w] & getActiveMask(vm, w, vstart, vl)
+        );
+    }
+
+    return result;
+}
+
+//
+// Return index of first active set bit in mask register vs2, or -1 (vfirst.m)
+//
+Uns64 riscvVKFirst(
+    riscvP       riscv,
+    Uns32        vs2,
+    riscvVKFlags flags,
+    Uns32        vstart,
+    Uns32        vl
+) {
+    Uns64 *vs2W = getVRegWords(riscv, vs2);
+    Uns64 *vm   = getMaskWords(riscv, flags);
+    Uns32  end  = getWordEnd(vstart, vl);
+    Uns32  w;
+
+    for(w=getWordStart(vstart); w<end; w++) {
+
+        Uns64 set = vs2W[w] & getActiveMask(vm, w, vstart, vl);
+
+        if(set) {
+            return (Uns64)w*64 + __builtin_ctzll(set);
+        }
+    }
+
+    return VK_NONE;
+}
+
+//
+// Return result bits in word w for set-before/including/only-first operation,
+// given the index of the first active set bit
+//
+static Uns64 getSetFirstWord(riscvVKFirstOp type, Uns64 first, Uns32 w) {
+
+    Uns64 before    = getBitsBefore(first, w);
+    Uns64 including = (first==VK_NONE) ? before : getBitsBefore(first+1, w);
+
+    if(type==RVVK_SBF) {
+        return before;
+    } else if(type==RVVK_SIF) {
+        return including;
+    } else {
+        return including & ~before;
+    }
+}
+
+//
+// Set mask register vd before, including or only the first active set bit in
+// mask register vs2 (vmsbf.m, vmsif.m and vmsof.m)
+//
+void riscvVKSetFirst(
+    riscvP         riscv,
+    Uns32          vd,
+    Uns32          vs2,
+    riscvVKFirstOp type,
+    riscvVKFlags   flags,
+    Uns32          vstart,
+    Uns32          vl
+) {
+    // find first active bit before any update (vd may overlap vs2 or v0)
+    Uns64  first = riscvVKFirst(riscv, vs2, flags, vstart, vl);
+    Uns64 *vdW   = getVRegWords(riscv, vd);
+    Uns64 *vm    = getMaskWords(riscv, flags);
+    Uns32  end   = getWordEnd(vstart, vl);
+    Uns32  w;
+
+    for(w=getWordStart(vstart); w<end; w++) {
+
+        Uns64 range  = getRangeMask(w, vstart, vl);
+        Uns64 active = getActiveMask(vm, w, vstart, vl);
+        Uns64 result = getSetFirstWord(type, first, w);
+
+        // update active elements
+        vdW[w] = (vdW[w] & ~active) | (result & active);
+
+        // set masked-off elements if required
+        if(flags & RVVK_VMA1) {
+            vdW[w] |= range & ~active;
+        }
+    }
+}
+
+//
+// Set each active element of SEW-bit register group vd to the count of active
+// set bits in mask register vs2 at lower indices (viota.m)
+//
+void riscvVKIota(
+    riscvP       riscv,
+    Uns32        vd,
+    Uns32        vs2,
+    Uns32        SEW,
+    riscvVKFlags flags,
+    Uns32        vstart,
+    Uns32        vl
+) {
+    Uns8  *vdB   = getVRegBytes(riscv, vd);
+    Uns64 *vs2W  = getVRegWords(riscv, vs2);
+    Uns64 *vm    = getMaskWords(riscv, flags);
+    Uns32  end   = getWordEnd(vstart, vl);
+    Uns64  count = 0;
+    Uns32  w;
+
+    for(w=getWordStart(vstart); w<end; w++) {
+
+        Uns64 range  = getRangeMask(w, vstart, vl);
+        Uns64 active = getActiveMask(vm, w, vstart, vl);
+        Uns64 set    = vs2W[w] & active;
+        Uns64 update = (flags & RVVK_VMA1) ? range : active;
+
+        // visit each element requiring update, deriving the count for active
+        // elements from the prefix population count within this word
+        while(update) {
+
+            Uns32 bit   = __builtin_ctzll(update);
+            Uns64 below = ((Uns64)1<<bit) - 1;
+            Uns64 value = -1;
+
+            if(active & (below+1)) {
+                value = count + __builtin_popcountll(set & below);
+            }
+
+            setElement(vdB, SEW, w*64+bit, value);
+
+            update &= update-1;
+        }
+
+        count += __builtin_popcountll(set);
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// PERMUTATION KERNELS
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Slide elements of register group vs2 up by offset into vd (vslideup)
+//
+void riscvVKSlideUp(
+    riscvP       riscv,
+    Uns32        vd,
+    Uns32        vs2,
+    Uns32        SEW,
+    riscvVKFlags flags,
+    Uns32        vstart,
+    Uns32        vl,
+    Uns64        offset
+) {
+    Uns8  *vdB   = getVRegBytes(riscv, vd);
+    Uns8  *vs2B  = getVRegBytes(riscv, vs2);
+    Uns64  first = (vstart>offset) ? vstart : offset;
+
+    // elements below offset are unchanged
+    if(first<vl) {
+
+        if(!(flags & RVVK_MASKED)) {
+
+            // unmasked: block copy (vd does not overlap vs2)
+            memcpy(
+                getElementPtr(vdB,  SEW, first),
+                getElementPtr(vs2B, SEW, first-offset),
+                (vl-first)*(SEW/8)
+            );
+
+        } else {
+
+            activeIter it;
+            Uns32      i;
+
+            startActive(&it, getMaskWords(riscv, flags), first, vl);
+
+            while(nextActive(&it, &i)) {
+                setElement(vdB, SEW, i, getElement(vs2B, SEW, i-offset));
+            }
+        }
+    }
+
+    fillMaskedOff(riscv, vdB, SEW, flags, vstart, vl);
+}
+
+//
+// Slide elements of register group vs2 down by offset into vd, with elements
+// from at or beyond vlmax taken as zero (vslidedown)
+//
+void riscvVKSlideDown(
+    riscvP       riscv,
+    Uns32        vd,
+    Uns32        vs2,
+    Uns32        SEW,
+    riscvVKFlags flags,
+    Uns32        vstart,
+    Uns32        vl,
+    Uns32        vlmax,
+    Uns64        offset
+) {
+    Uns8 *vdB  = getVRegBytes(riscv, vd);
+    Uns8 *vs2B = getVRegBytes(riscv, vs2);
+
+    // clamp offset to vlmax
+    if(offset>vlmax) {
+        offset = vlmax;
+    }
+
+    if(vstart>=vl) {
+
+        // no action
+
+    } else if(!(flags & RVVK_MASKED)) {
+
+        // elements [vstart,split) come from the source, [split,vl) are zero
+        Uns32 split = vlmax-offset;
+
+        split = (split<vstart) ? vstart : (split>vl) ? vl : split;
+
+        // unmasked: block move (vd may overlap vs2 at a lower address)
+        memmove(
+            getElementPtr(vdB,  SEW, vstart),
+            getElementPtr(vs2B, SEW, vstart+offset),
+            (split-vstart)*(SEW/8)
+        );
+
+        memset(getElementPtr(vdB, SEW, split), 0, (vl-split)*(SEW/8));
+
+    } else {
+
+        activeIter it;
+        Uns32      i;
+
+        startActive(&it, getMaskWords(riscv, flags), vstart, vl);
+
+        // ascending order reads each overlapping source before it is written
+        while(nextActive(&it, &i)) {
+
+            Uns64 src   = i+offset;
+            Uns64 value = (src<vlmax) ? getElement(vs2B, SEW, src) : 0;
+
+            setElement(vdB, SEW, i, value);
+        }
+    }
+
+    fillMaskedOff(riscv, vdB, SEW, flags, vstart, vl);
+}
+
+//
+// Slide elements of register group vs2 up by one into vd, inserting value at
+// element 0 (vslide1up and vfslide1up)
+//
+void riscvVKSlide1Up(
+    riscvP       riscv,
+    Uns32        vd,
+    Uns32        vs2,
+    Uns32        SEW,
+    riscvVKFlags flags,
+    Uns32        vstart,
+    Uns32        vl,
+    Uns64        value
+) {
+    Uns8 *vdB  = getVRegBytes(riscv, vd);
+    Uns8 *vs2B = getVRegBytes(riscv, vs2);
+
+    if(vstart>=vl) {
+
+        // no action
+
+    } else if(!(flags & RVVK_MASKED)) {
+
+        Uns32 first = vstart ? vstart : 1;
+
+        // insert scalar at element 0
+        if(!vstart) {
+            setElement(vdB, SEW, 0, value);
+        }
+
+        // unmasked: block copy (vd does not overlap vs2)
+        memcpy(
+            getElementPtr(vdB,  SEW, first),
+            getElementPtr(vs2B, SEW, first-1),
+            (vl-first)*(SEW/8)
+        );
+
+    } else {
+
+        activeIter it;
+        Uns32      i;
+
+        startActive(&it, getMaskWords(riscv, flags), vstart, vl);
+
+        while(nextActive(&it, &i)) {
+            setElement(vdB, SEW, i, i ? getElement(vs2B, SEW, i-1) : value);
+        }
+    }
+
+    fillMaskedOff(riscv, vdB, SEW, flags, vstart, vl);
+}
+
+//
+// Slide elements of register group vs2 down by one into vd, inserting value at
+// element vl-1 (vslide1down and vfslide1down)
+//
+void riscvVKSlide1Down(
+    riscvP       riscv,
+    Uns32        vd,
+    Uns32        vs2,
+    Uns32        SEW,
+    riscvVKFlags flags,
+    Uns32        vstart,
+    Uns32        vl,
+    Uns64        value
+) {
+    Uns8 *vdB  = getVRegBytes(riscv, vd);
+    Uns8 *vs2B = getVRegBytes(riscv, vs2);
+
+    if(vstart>=vl) {
+
+        // no action
+
+    } else if(!(flags & RVVK_MASKED)) {
+
+        // unmasked: block move (vd may overlap vs2 at a lower address)
+        memmove(
+            getElementPtr(vdB,  SEW, vstart),
+            getElementPtr(vs2B, SEW, vstart+1),
+            (vl-1-vstart)*(SEW/8)
+        );
+
+        // insert scalar at element vl-1
+        setElement(vdB, SEW, vl-1, value);
+
+    } else {
+
+        activeIter it;
+        Uns32      i;
+
+        startActive(&it, getMaskWords(riscv, flags), vstart, vl);
+
+        // ascending order reads each overlapping source before it is written
+        while(nextActive(&it, &i)) {
+            setElement(vdB, SEW, i, (i+1<vl) ? getElement(vs2B, SEW, i+1) : value);
+        }
+    }
+
+    fillMaskedOff(riscv, vdB, SEW, flags, vstart, vl);
+}
+
+//
+// Set active elements of register group vd to the element of vs2 selected by
+// the given index, or zero if the index is at or beyond vlmax (vrgather.vx
+// and vrgather.vi)
+//
+void riscvVKGatherX(
+    riscvP       riscv,
+    Uns32        vd,
+    Uns32        vs2,
+    Uns32        SEW,
+    riscvVKFlags flags,
+    Uns32        vstart,
+    Uns32        vl,
+    Uns32        vlmax,
+    Uns64        index
+) {
+    Uns8      *vdB   = getVRegBytes(riscv, vd);
+    Uns8      *vs2B  = getVRegBytes(riscv, vs2);
+    Uns64      value = (index<vlmax) ? getElement(vs2B, SEW, index) : 0;
+    activeIter it;
+    Uns32      i;
+
+    startActive(&it, getMaskWords(riscv, flags), vstart, vl);
+
+    while(nextActive(&it, &i)) {
+        setElement(vdB, SEW, i, value);
+    }
+
+    fillMaskedOff(riscv, vdB, SEW, flags, vstart, vl);
+}
+
+//
+// Set active elements of register group vd to the element of vs2 selected by
+// the corresponding EEW-bit element of vs1, or zero if that index is at or
+// beyond vlmax (vrgather.vv and vrgatherei16.vv)
+//
+void riscvVKGatherV(
+    riscvP       riscv,
+    Uns32        vd,
+    Uns32        vs2,
+    Uns32        vs1,
+    Uns32        SEW,
+    Uns32        EEW,
+    riscvVKFlags flags,
+    Uns32        vstart,
+    Uns32        vl,
+    Uns32        vlmax
+) {
+    Uns8      *vdB  = getVRegBytes(riscv, vd);
+    Uns8      *vs2B = getVRegBytes(riscv, vs2);
+    Uns8      *vs1B = getVRegBytes(riscv, vs1);
+    activeIter it;
+    Uns32      i;
+
+    startActive(&it, getMaskWords(riscv, flags), vstart, vl);
+
+    // vd does not overlap vs1 or vs2, so no source is modified
+    while(nextActive(&it, &i)) {
+
+        Uns64 index = getElement(vs1B, EEW, i);
+        Uns64 value = (index<vlmax) ? getElement(vs2B, SEW, index) : 0;
+
+        setElement(vdB, SEW, i, value);
+    }
+
+    fillMaskedOff(riscv, vdB, SEW, flags, vstart, vl);
+}
+
+//
+// Pack elements of register group vs2 selected by mask register vs1 into
+// consecutive elements of vd (vcompress.vm)
+//
+void riscvVKCompress(
+    riscvP riscv,
+    Uns32  vd,
+    Uns32  vs2,
+    Uns32  vs1,
+    Uns32  SEW,
+    Uns32  vstart,
+    Uns32  vl
+) {
+    Uns8      *vdB  = getVRegBytes(riscv, vd);
+    Uns8      *vs2B = getVRegBytes(riscv, vs2);
+    Uns32      k    = 0;
+    activeIter it;
+    Uns32      i;
+
+    startActive(&it, getVRegWords(riscv, vs1), vstart, vl);
+
+    while(nextActive(&it, &i)) {
+        setElement(vdB, SEW, k++, getElement(vs2B, SEW, i));
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// REDUCTION KERNELS
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Apply loop body _BODY to accumulator _A for each element in range [_S,_E);
+// each loop has a single operation and no early exit so that the host compiler
+// can vectorize it
+//
+#define VK_RED_LOOP(_A, _BODY, _S, _E) { \
+    Uns32 _i;                                   \
+    for(_i=_S; _i<_E; _i++) {                   \
+        _A = _BODY;                             \
+    }                                           \
+}
+
+//
+// Minimum and maximum of two values of the same type
+//
+#define VK_MIN(_A, _B) (((_B)<(_A)) ? (_B) : (_A))
+#define VK_MAX(_A, _B) (((_B)>(_A)) ? (_B) : (_A))
+
+//
+// Define function reducing _B-bit elements in range [start,end) of the given
+// register group into accumulator acc
+//
+#define VK_RED_SEW(_B) \
+static Uns64 reduceRange##_B(                                               \
+    riscvVKRedOp op,                                                        \
+    const Uns8  *vs2B,                                                      \
+    Uns32        start,                                                     \
+    Uns32        end,                                                       \
+    Uns64        acc                                                        \
+) {                                                                         \
+    const Uns##_B *u  = (const Uns##_B *)vs2B;                              \
+    const Int##_B *s  = (const Int##_B *)vs2B;                              \
+    Uns##_B        ua = acc;                                                \
+    Int##_B        sa = acc;                                                \
+                                                                            \
+    switch(op) {                                                            \
+        case RVVK_RSUM:  VK_RED_LOOP(ua, ua+u[_i],          start, end); break; \
+        case RVVK_RAND:  VK_RED_LOOP(ua, ua&u[_i],          start, end); break; \
+        case RVVK_ROR:   VK_RED_LOOP(ua, ua|u[_i],          start, end); break; \
+        case RVVK_RXOR:  VK_RED_LOOP(ua, ua^u[_i],          start, end); break; \
+        case RVVK_RMINU: VK_RED_LOOP(ua, VK_MIN(ua, u[_i]), start, end); break; \
+        case RVVK_RMAXU: VK_RED_LOOP(ua, VK_MAX(ua, u[_i]), start, end); break; \
+        case RVVK_RMIN:  VK_RED_LOOP(sa, VK_MIN(sa, s[_i]), start, end); return sa; \
+        case RVVK_RMAX:  VK_RED_LOOP(sa, VK_MAX(sa, s[_i]), start, end); return sa; \
+    }                                                                       \
+                                                                            \
+    return ua;                                                              \
+}
+
+//
+// Define function summing _B-bit elements in range [start,end) of the given
+// register group into _W-bit accumulator acc, with sign or zero extension
+//
+#define VK_WRED_SEW(_B, _W) \
+static Uns64 reduceRangeW##_B(                                              \
+    Bool         isSigned,                                                  \
+    const Uns8  *vs2B,                                                      \
+    Uns32        start,                                                     \
+    Uns32        end,                                                       \
+    Uns64        acc                                                        \
+) {                                                                         \
+    const Uns##_B *u = (const Uns##_B *)vs2B;                               \
+    const Int##_B *s = (const Int##_B *)vs2B;                               \
+    Uns##_W        a = acc;                                                 \
+                                                                            \
+    if(isSigned) {                                                          \
+        VK_RED_LOOP(a, a+(Int##_W)s[_i], start, end);                       \
+    } else {                                                                \
+        VK_RED_LOOP(a, a+(Uns##_W)u[_i], start, end);                       \
+    }                                                                       \
+                                                                            \
+    return a;                                                               \
+}
+
+VK_RED_SEW(8)
+VK_RED_SEW(16)
+VK_RED_SEW(32)
+VK_RED_SEW(64)
+VK_WRED_SEW(8,  16)
+VK_WRED_SEW(16, 32)
+VK_WRED_SEW(32, 64)
+
+//
+// Reduce SEW-bit elements in contiguous range [start,end) into accumulator acc
+//
+static Uns64 reduceRange(
+    const Uns8  *vs2B,
+    Uns32        SEW,
+    riscvVKRedOp op,
+    riscvVKFlags flags,
+    Uns32        start,
+    Uns32        end,
+    Uns64        acc
+) {
+    if(flags & RVVK_WIDEN) {
+
+        Bool isSigned = flags & RVVK_SIGNED;
+
+        switch(SEW) {
+            case 8:  return reduceRangeW8 (isSigned, vs2B, start, end, acc);
+            case 16: return reduceRangeW16(isSigned, vs2B, start, end, acc);
+            default: return reduceRangeW32(isSigned, vs2B, start, end, acc);
+        }
+
+    } else {
+
+        switch(SEW) {
+            case 8:  return reduceRange8 (op, vs2B, start, end, acc);
+            case 16: return reduceRange16(op, vs2B, start, end, acc);
+            case 32: return reduceRange32(op, vs2B, start, end, acc);
+            default: return reduceRange64(op, vs2B, start, end, acc);
+        }
+    }
+}
+
+//
+// Return the result of combining accumulator acc with active SEW-bit elements
+// of register group vs2 using the given integer reduction operation
+//
+Uns64 riscvVKRedInt(
+    riscvP       riscv,
+    Uns32        vs2,
+    Uns32        SEW,
+    riscvVKRedOp op,
+    riscvVKFlags flags,
+    Uns32        vstart,
+    Uns32        vl,
+    Uns64        acc
+) {
+    Uns8  *vs2B = getVRegBytes(riscv, vs2);
+    Uns64 *vm   = getMaskWords(riscv, flags);
+
+    if(!vm) {
+
+        // all elements in range are active
+        if(vstart<vl) {
+            acc = reduceRange(vs2B, SEW, op, flags, vstart, vl, acc);
+        }
+
+    } else {
+
+        Uns32 end = getWordEnd(vstart, vl);
+        Uns32 w;
+
+        // reduce each run of consecutive active elements as a contiguous range
+        for(w=getWordStart(vstart); w<end; w++) {
+
+            Uns64 active = getActiveMask(vm, w, vstart, vl);
+
+            while(active) {
+
+                Uns32 run;
+                Uns32 base = w*64 + takeRun(&active, &run);
+
+                acc = reduceRange(vs2B, SEW, op, flags, base, base+run, acc);
+            }
+        }
+    }
+
+    return acc;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// FLOATING POINT KERNELS
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Maximum number of elements processed by one floating point run (runs never
+// cross a mask word)
+//
+#define VK_FLT_RUN 64
+
+//
+// Apply expression _EXPR to each element of run [0,n) writing result r[i]
+//
+#define VK_FLT_LOOP(_EXPR) { \
+    for(i=0; i<n; i++) {                        \
+        r[i] = _EXPR;                           \
+    }                                           \
+}
+
+//
+// Host fused multiply-add and square root functions for each element width
+//
+#define VK_FMA_32  fmaf
+#define VK_FMA_64  fma
+#define VK_SQRT_32 sqrtf
+#define VK_SQRT_64 sqrt
+
+//
+// Define function applying floating point operation op to _B-bit elements in
+// run [0,n), returning True if any result is a NaN. These functions are never
+// inlined so that all host operations complete before host exception flags
+// are read by the caller
+//
+#define VK_FLT_SEW(_B) \
+static __attribute__((noinline)) Bool fltRun##_B(                           \
+    riscvVKFltOp   op,                                                      \
+    Flt##_B       *r,                                                       \
+    const Flt##_B *a,                                                       \
+    const Flt##_B *b,                                                       \
+    const Flt##_B *c,                                                       \
+    Uns32          n                                                        \
+) {                                                                         \
+    Bool  isNaN = False;                                                    \
+    Uns32 i;                                                                \
+                                                                            \
+    switch(op) {                                                            \
+        case RVVK_FADD:   VK_FLT_LOOP(a[i]+b[i]);                   break;  \
+        case RVVK_FSUB:   VK_FLT_LOOP(a[i]-b[i]);                   break;  \
+        case RVVK_FMUL:   VK_FLT_LOOP(a[i]*b[i]);                   break;  \
+        case RVVK_FDIV:   VK_FLT_LOOP(a[i]/b[i]);                   break;  \
+        case RVVK_FSQRT:  VK_FLT_LOOP(VK_SQRT_##_B(a[i]));          break;  \
+        case RVVK_FMADD:  VK_FLT_LOOP(VK_FMA_##_B( a[i], b[i],  c[i])); break; \
+        case RVVK_FNMADD: VK_FLT_LOOP(VK_FMA_##_B(-a[i], b[i], -c[i])); break; \
+        case RVVK_FMSUB:  VK_FLT_LOOP(VK_FMA_##_B( a[i], b[i], -c[i])); break; \
+        case RVVK_FNMSUB: VK_FLT_LOOP(VK_FMA_##_B(-a[i], b[i],  c[i])); break; \
+    }                                                                       \
+                                                                            \
+    for(i=0; i<n; i++) {                                                    \
+        isNaN |= (r[i]!=r[i]);                                              \
+    }                                                                       \
+                                                                            \
+    return isNaN;                                                           \
+}
+
+VK_FLT_SEW(32)
+VK_FLT_SEW(64)
+
+//
+// Return host pointer to bytes of the floating point operand register with
+// the given index in packed register indices, or NULL if it is a scalar
+//
+static Uns8 *getFltOperand(riscvP riscv, Uns32 regs, Uns32 index) {
+
+    Uns32 r = (regs>>(index*8)) & 0xff;
+
+    return (r==RVVK_FSCALAR) ? 0 : getVRegBytes(riscv, r);
+}
+
+//
+// Merge host floating point exception flags into vmiFPFlags
+//
+static void mergeHostFlags(vmiFPFlags *vmiFlags) {
+
+    Int32 except = fetestexcept(FE_ALL_EXCEPT);
+
+    if(except & FE_INVALID)   {vmiFlags->f.I = 1;}
+    if(except & FE_DIVBYZERO) {vmiFlags->f.Z = 1;}
+    if(except & FE_OVERFLOW)  {vmiFlags->f.O = 1;}
+    if(except & FE_UNDERFLOW) {vmiFlags->f.U = 1;}
+    if(except & FE_INEXACT)   {vmiFlags->f.P = 1;}
+}
+
+//
+// Apply floating point operation to one run of elements [first,first+n),
+// returning False if any result is a NaN (in which case vd is not updated)
+//
+static Bool fltRun(
+    riscvP       riscv,
+    riscvVKFltOp op,
+    Uns32        SEW,
+    Uns32        regs,
+    Uns64       *bcast,
+    Uns32        first,
+    Uns32        n,
+    vmiFPFlags  *vmiFlags
+) {
+    Uns32       bytes = SEW/8;
+    Uns8       *vdB   = getFltOperand(riscv, regs, 0);
+    const void *src[3];
+    Uns64       result[VK_FLT_RUN];
+    Bool        isNaN;
+    Uns32       i;
+
+    // get operands for the run (a scalar operand uses the broadcast buffer)
+    for(i=0; i<3; i++) {
+        Uns8 *base = getFltOperand(riscv, regs, i+1);
+        src[i] = base ? (void *)(base+first*bytes) : (void *)bcast;
+    }
+
+    feclearexcept(FE_ALL_EXCEPT);
+
+    // results are buffered because vd may be a source operand
+    if(SEW==32) {
+        isNaN = fltRun32(op, (Flt32 *)result, src[0], src[1], src[2], n);
+    } else {
+        isNaN = fltRun64(op, (Flt64 *)result, src[0], src[1], src[2], n);
+    }
+
+    // commit results and flags only if no special value handling is required
+    if(!isNaN) {
+        memcpy(vdB+first*bytes, result, n*bytes);
+        mergeHostFlags(vmiFlags);
+    }
+
+    return !isNaN;
+}
+
+//
+// Apply floating point operation op to active SEW-bit elements, where operands
+// and destination are packed by RVVK_FREGS and any scalar operand has value
+// scalar. Only round-to-nearest-even is implemented, and elements from the
+// first run of active elements that would produce a NaN result are not
+// processed, so that the caller can complete the operation element by element.
+// Returns the index of the first unprocessed element (vl if all elements were
+// processed) in bits 31:0 and the vmiFPFlags raised by processed elements in
+// bits 39:32
+//
+Uns64 riscvVKFlt(
+    riscvP       riscv,
+    riscvVKFltOp op,
+    Uns32        SEW,
+    riscvVKFlags flags,
+    Uns32        vstart,
+    Uns32        vl,
+    Uns32        regs,
+    Uns64        scalar
+) {
+    vmiFPFlags vmiFlags = {0};
+    Uns32      next     = vstart;
+
+    // dynamic rounding mode must be round-to-nearest-even (frm=0)
+    if(!RD_CSR_FIELDC(riscv, fcsr, frm) && (vstart<vl)) {
+
+        Uns64  bcast[VK_FLT_RUN];
+        Uns64 *vm  = getMaskWords(riscv, flags);
+        Uns32  end = getWordEnd(vstart, vl);
+        Bool   ok  = True;
+        fenv_t env;
+        Uns32  w;
+
+        // broadcast any scalar operand to the width of one run
+        for(w=0; w<VK_FLT_RUN; w++) {
+            setElement((Uns8 *)bcast, SEW, w, scalar);
+        }
+
+        // save host floating point environment and select round-to-nearest
+        feholdexcept(&env);
+        fesetround(FE_TONEAREST);
+
+        // process each run of consecutive active elements
+        for(w=getWordStart(vstart); ok && (w<end); w++) {
+
+            Uns64 active = getActiveMask(vm, w, vstart, vl);
+
+            while(ok && active) {
+
+                Uns32 run;
+                Uns32 first = w*64 + takeRun(&active, &run);
+
+                // stop at the first run requiring special value handling
+                if(!fltRun(riscv, op, SEW, regs, bcast, first, run, &vmiFlags)) {
+                    next = first;
+                    ok   = False;
+                }
+            }
+        }
+
+        // restore host floating point environment
+        fesetenv(&env);
+
+        // all elements were processed if no run was rejected
+        if(ok) {
+            next = vl;
+        }
+
+        // set masked-off elements in the processed range if required
+        fillMaskedOff(riscv, getFltOperand(riscv, regs, 0), SEW, flags, vstart, next);
+    }
+
+    return next | ((Uns64)vmiFlags.bits<<32);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// MEMORY ACCESS KERNELS
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Memory is transferred directly through host pointers one page at a time
+//
+#define VK_PAGE_SHIFT 12
+#define VK_PAGE_BYTES (1<<VK_PAGE_SHIFT)
+
+//
+// Maximum number of pages resolved by one probe of a load range
+//
+#define VK_PAGE_NUM 16
+
+//
+// Maximum number of bytes in a segment (eight 64-bit fields)
+//
+#define VK_SEGMENT_BYTES 64
+
+//
+// This describes a page of plain memory resolved to a host pointer
+//
+typedef struct vkPageS {
+    Uns64  page;            // page number
+    Uns8  *host;            // host pointer to start of page
+} vkPage, *vkPageP;
+
+//
+// This describes a strided or indexed vector memory access
+//
+typedef struct vkMemAccessS {
+    riscvP       riscv;     // accessing hart
+    memDomainP   domain;    // current data domain
+    Uns8        *vd;        // data register group (first field)
+    Uns8        *vs2;       // index register group (or NULL if strided)
+    Uns32        EEW;       // data element width
+    Uns32        IEEW;      // index element width
+    Uns32        fields;    // number of fields in each segment
+    Uns32        fieldGap;  // byte offset between field register groups
+    Uns32        segBytes;  // bytes in each segment
+    Bool         contig;    // whether consecutive segments are contiguous
+    riscvVKFlags flags;     // kernel flags
+    Uns64        base;      // base address
+    Uns64        stride;    // byte stride between segments (if strided)
+    Uns64        addrMask;  // mask applied to calculated addresses
+    Uns32        pageNum;   // number of resolved pages
+    Uns32        pageLast;  // most-recently used resolved page
+    vkPage       pages[VK_PAGE_NUM];
+} vkMemAccess, *vkMemAccessP;
+
+//
+// This enumerates the outcome of resolving the page holding a segment
+//
+typedef enum vkResolveE {
+    VKR_NATIVE,     // segment is in a resolved page
+    VKR_DONE,       // segment was transferred by a true access
+    VKR_FULL,       // no room to resolve another page
+    VKR_LAST,       // segment was transferred, but its page is not plain memory
+    VKR_STOP,       // segment was not transferred (misaligned or access failed)
+} vkResolve;
+
+//
+// Return the address of the indexed segment
+//
+static Uns64 getMemAddress(vkMemAccessP ma, Uns32 index) {
+
+    Uns64 offset;
+
+    if(!ma->vs2) {
+
+        offset = index*ma->stride;
+
+    } else {
+
+        Uns32 shift = 64-ma->IEEW;
+
+        offset = getElement(ma->vs2, ma->IEEW, index);
+
+        if(ma->flags & RVVK_SIGNED) {
+            offset = (Int64)(offset<<shift) >> shift;
+        }
+    }
+
+    return (ma->base+offset) & ma->addrMask;
+}
+
+//
+// Return host pointer to the indexed element of field f
+//
+inline static Uns8 *getFieldPtr(vkMemAccessP ma, Uns32 f, Uns32 index) {
+    return getElementPtr(ma->vd + f*ma->fieldGap, ma->EEW, index);
+}
+
+//
+// Return the byte offset of the given address within its page
+//
+inline static Uns32 getPageOffset(Uns64 address) {
+    return address & (VK_PAGE_BYTES-1);
+}
+
+//
+// Does the segment at the given address straddle a page boundary?
+//
+inline static Bool straddlesPage(vkMemAccessP ma, Uns64 address) {
+    return getPageOffset(address)+ma->segBytes > VK_PAGE_BYTES;
+}
+
+//
+// Return the number of segments of a run of the given length starting at the
+// given address that can be transferred through the page holding the first
+// (only contiguous segments are transferred more than one at a time)
+//
+static Uns32 getPageRun(vkMemAccessP ma, Uns64 address, Uns32 run) {
+
+    Uns32 num = 1;
+
+    if(ma->contig) {
+        num = (VK_PAGE_BYTES-getPageOffset(address)) / ma->segBytes;
+        num = num ? VK_MIN(num, run) : 1;
+    }
+
+    return num;
+}
+
+//
+// Transfer bytes between memory at the given address and buffer
+//
+static Bool accessBytes(
+    vkMemAccessP ma,
+    Uns64        address,
+    void        *buffer,
+    Uns32        bytes
+) {
+    if(ma->flags & RVVK_STORE) {
+        return vmirtWriteNByteDomain(
+            ma->domain, address, buffer, bytes, 0, MEM_AA_TRUE
+        );
+    } else {
+        return vmirtReadNByteDomain(
+            ma->domain, address, buffer, bytes, 0, MEM_AA_TRUE
+        );
+    }
+}
+
+//
+// Transfer the indexed segment to or from memory at the given address with a
+// single true access of the whole segment, gathering fields from or
+// scattering them to their register groups. vstart is set to the segment
+// index beforehand so that any exception taken by the access is reported
+// exactly as by the per-element loop (or, for a fault-only-first load, so that
+// vl is reduced to the segment index if the exception is suppressed)
+//
+static Bool accessSegment(vkMemAccessP ma, Uns32 index, Uns64 address) {
+
+    Uns32 bytes = ma->EEW/8;
+    Uns8  buffer[VK_SEGMENT_BYTES];
+    Uns32 f;
+
+    WR_CSRC(ma->riscv, vstart, index);
+
+    if(ma->flags & RVVK_STORE) {
+
+        for(f=0; f<ma->fields; f++) {
+            memcpy(buffer+f*bytes, getFieldPtr(ma, f, index), bytes);
+        }
+
+        return accessBytes(ma, address, buffer, ma->segBytes);
+
+    } else if(!accessBytes(ma, address, buffer, ma->segBytes)) {
+
+        return False;
+
+    } else {
+
+        for(f=0; f<ma->fields; f++) {
+            memcpy(getFieldPtr(ma, f, index), buffer+f*bytes, bytes);
+        }
+
+        return True;
+    }
+}
+
+//
+// Copy all fields of segment src to segment dst
+//
+static void copySegment(vkMemAccessP ma, Uns32 dst, Uns32 src) {
+
+    Uns32 f;
+
+    for(f=0; f<ma->fields; f++) {
+        memcpy(getFieldPtr(ma, f, dst), getFieldPtr(ma, f, src), ma->EEW/8);
+    }
+}
+
+//
+// Return a host pointer to the page with the given number if it is plain
+// memory in the current data domain, accessible with current privilege and
+// without callbacks or watchpoints, or NULL otherwise. This is an artifact
+// query: it neither takes exceptions nor establishes address mappings
+//
+static Uns8 *getNativePage(vkMemAccessP ma, Uns64 page) {
+
+    Uns64 address = page<<VK_PAGE_SHIFT;
+
+    if(ma->flags & RVVK_STORE) {
+        return vmirtGetWriteNByteDst(
+            ma->domain, address, VK_PAGE_BYTES, MEM_CONSTRAINT_NONE, MEM_AA_FALSE
+        );
+    } else {
+        return (Uns8 *)vmirtGetReadNByteSrc(
+            ma->domain, address, VK_PAGE_BYTES, MEM_CONSTRAINT_NONE, MEM_AA_FALSE
+        );
+    }
+}
+
+//
+// Return the resolved page holding the given address
+//
+static vkPageP findPage(vkMemAccessP ma, Uns64 address) {
+
+    Uns64 page = address>>VK_PAGE_SHIFT;
+    Uns32 i;
+
+    if(ma->pageNum && (ma->pages[ma->pageLast].page==page)) {
+        return &ma->pages[ma->pageLast];
+    }
+
+    for(i=0; i<ma->pageNum; i++) {
+        if(ma->pages[i].page==page) {
+            ma->pageLast = i;
+            return &ma->pages[i];
+        }
+    }
+
+    return 0;
+}
+
+//
+// Resolve the page holding the indexed segment at the given address. A page
+// not yet resolved is first queried directly; if that fails the segment is
+// transferred with a true access (so that any exception is taken and any
+// address mapping established) and the page queried again
+//
+static vkResolve resolveSegment(vkMemAccessP ma, Uns32 index, Uns64 address) {
+
+    Uns64 last = address+ma->segBytes-1;
+
+    if(address & (ma->EEW/8-1)) {
+
+        // misaligned elements are left to the per-element loop
+        return VKR_STOP;
+
+    } else if((last & ma->addrMask) < address) {
+
+        // as are segments wrapping at the top of the address space
+        return VKR_STOP;
+
+    } else if(straddlesPage(ma, address)) {
+
+        // segments straddling a page boundary are accessed directly
+        return accessSegment(ma, index, address) ? VKR_DONE : VKR_STOP;
+
+    } else if(findPage(ma, address)) {
+
+        // page already resolved
+        return VKR_NATIVE;
+
+    } else if(ma->pageNum==VK_PAGE_NUM) {
+
+        // no room to resolve another page
+        return VKR_FULL;
+
+    } else {
+
+        Uns64     page   = address>>VK_PAGE_SHIFT;
+        Uns8     *host   = getNativePage(ma, page);
+        vkResolve result = VKR_NATIVE;
+
+        if(!host) {
+
+            if(!accessSegment(ma, index, address)) {
+                return VKR_STOP;
+            }
+
+            host   = getNativePage(ma, page);
+            result = VKR_DONE;
+        }
+
+        if(!host) {
+
+            // page is not plain memory
+            result = VKR_LAST;
+
+        } else {
+
+            ma->pageLast = ma->pageNum++;
+            ma->pages[ma->pageLast].page = page;
+            ma->pages[ma->pageLast].host = host;
+        }
+
+        return result;
+    }
+}
+
+//
+// Transfer a run of active segments in resolved pages directly through host
+// pointers: a run of contiguous single-field elements needs one copy per page,
+// while segment fields are scattered from or gathered to memory. Segments
+// straddling a page boundary have been transferred by resolveSegment
+//
+static void copyRun(vkMemAccessP ma, Uns32 first, Uns32 run) {
+
+    Uns32 bytes   = ma->EEW/8;
+    Bool  isStore = ma->flags & RVVK_STORE;
+
+    while(run) {
+
+        Uns64 address = getMemAddress(ma, first);
+        Uns32 num     = getPageRun(ma, address, run);
+
+        if(!straddlesPage(ma, address)) {
+
+            Uns8 *host = findPage(ma, address)->host + getPageOffset(address);
+
+            if(ma->fields==1) {
+
+                Uns8 *reg = getElementPtr(ma->vd, ma->EEW, first);
+
+                if(isStore) {
+                    memcpy(host, reg, num*bytes);
+                } else {
+                    memcpy(reg, host, num*bytes);
+                }
+
+            } else {
+
+                Uns32 i, f;
+
+                for(i=0; i<num; i++) {
+                    for(f=0; f<ma->fields; f++, host+=bytes) {
+
+                        Uns8 *reg = getFieldPtr(ma, f, first+i);
+
+                        if(isStore) {
+                            memcpy(host, reg, bytes);
+                        } else {
+                            memcpy(reg, host, bytes);
+                        }
+                    }
+                }
+            }
+        }
+
+        first += num;
+        run   -= num;
+    }
+}
+
+//
+// Resolve pages holding active segments in range [vstart,vl), stopping at
+// the first segment that cannot be resolved (with the reason in *resultP).
+// For stores, each segment is also transferred as soon as its page is
+// resolved, so that stores are performed in element order. Returns the index
+// of the segment at which resolution stopped (or vl)
+//
+static Uns32 resolveRange(
+    vkMemAccessP ma,
+    Uns32        vstart,
+    Uns32        vl,
+    vkResolve   *resultP
+) {
+    Bool   isStore = ma->flags & RVVK_STORE;
+    Uns64 *vm      = getMaskWords(ma->riscv, ma->flags);
+    Uns32  end     = getWordEnd(vstart, vl);
+    Uns32  w;
+
+    for(w=getWordStart(vstart); w<end; w++) {
+
+        Uns64 active = getActiveMask(vm, w, vstart, vl);
+
+        while(active) {
+
+            Uns32 run;
+            Uns32 first = w*64 + takeRun(&active, &run);
+
+            while(run) {
+
+                Uns64     address = getMemAddress(ma, first);
+                vkResolve result  = resolveSegment(ma, first, address);
+                Uns32     num     = getPageRun(ma, address, run);
+
+                if(isStore && (result==VKR_FULL)) {
+
+                    // stores need not retain resolved pages
+                    ma->pageNum = 0;
+                    num         = 0;
+
+                } else if(result>=VKR_FULL) {
+
+                    *resultP = result;
+                    return first;
+
+                } else if(isStore) {
+
+                    // a segment transferred by true access is not copied again
+                    Uns32 skip = (result==VKR_DONE);
+
+                    copyRun(ma, first+skip, num-skip);
+                }
+
+                first += num;
+                run   -= num;
+            }
+        }
+    }
+
+    *resultP = VKR_NATIVE;
+
+    return vl;
+}
+
+//
+// Copy active segments in range [vstart,vl), all in resolved pages
+//
+static void copyRange(vkMemAccessP ma, Uns32 vstart, Uns32 vl) {
+
+    Uns64 *vm  = getMaskWords(ma->riscv, ma->flags);
+    Uns32  end = getWordEnd(vstart, vl);
+    Uns32  w;
+
+    for(w=getWordStart(vstart); w<end; w++) {
+
+        Uns64 active = getActiveMask(vm, w, vstart, vl);
+
+        while(active) {
+
+            Uns32 run;
+            Uns32 first = w*64 + takeRun(&active, &run);
+
+            copyRun(ma, first, run);
+        }
+    }
+}
+
+//
+// Transfer active segments in range [vstart,vl) to or from memory, returning
+// the index of the first segment not transferred. Loads first probe the range
+// up to the first segment that faults (reducing vl for a fault-only-first
+// load) or is not in plain memory and then copy that prefix in bulk; stores
+// are transferred in order as pages are resolved
+//
+static Uns32 accessRange(vkMemAccessP ma, Uns32 vstart, Uns32 vl) {
+
+    Uns32 next = vstart;
+
+    while(next<vl) {
+
+        vkResolve result;
+        Uns32     limit;
+
+        ma->pageNum = 0;
+
+        limit = resolveRange(ma, next, vl, &result);
+
+        if(!(ma->flags & RVVK_STORE)) {
+            copyRange(ma, next, limit);
+        }
+
+        if(result==VKR_FULL) {
+            next = limit;
+        } else if(result==VKR_LAST) {
+            return limit+1;
+        } else {
+            return limit;
+        }
+    }
+
+    return next;
+}
+
+//
+// Transfer active segments in range [vstart,vl) for a zero-stride load that
+// need be performed only once: the first active segment is loaded and copied
+// to all others
+//
+static Uns32 broadcastRange(vkMemAccessP ma, Uns32 vstart, Uns32 vl) {
+
+    Uns64      *vm = getMaskWords(ma->riscv, ma->flags);
+    activeIter  it;
+    Uns32       src;
+    Uns32       dst;
+
+    startActive(&it, vm, vstart, vl);
+
+    if(!nextActive(&it, &src)) {
+
+        // no active segments
+        return vl;
+
+    } else {
+
+        Uns64     address = getMemAddress(ma, src);
+        vkResolve result  = resolveSegment(ma, src, address);
+
+        if(result==VKR_STOP) {
+
+            // misaligned or failed (a page that is not plain memory does not
+            // matter, because it is accessed only once)
+            return src;
+
+        } else if(result==VKR_NATIVE) {
+
+            copyRun(ma, src, 1);
+        }
+
+        while(nextActive(&it, &dst)) {
+            copySegment(ma, dst, src);
+        }
+
+        return vl;
+    }
+}
+
+//
+// Common implementation of strided and indexed load/store kernels
+//
+static Uns32 accessMemory(vkMemAccessP ma, Uns32 vstart, Uns32 vl) {
+
+    riscvVKFlags flags   = ma->flags;
+    Bool         isStore = flags & RVVK_STORE;
+    Uns32        next    = vstart;
+
+    if(vstart<vl) {
+
+        if(!ma->vs2 && !ma->stride && (flags&RVVK_BCAST) && !isStore) {
+            next = broadcastRange(ma, vstart, vl);
+        } else {
+            next = accessRange(ma, vstart, vl);
+        }
+
+        // set masked-off load destination elements if required (as in the
+        // per-element loop, only the first field is affected)
+        if(!isStore) {
+            fillMaskedOff(ma->riscv, ma->vd, ma->EEW, flags, vstart, next);
+        }
+    }
+
+    return next;
+}
+
+//
+// Fill segment layout in memory access descriptor
+//
+static void setSegment(vkMemAccessP ma, Uns32 segment) {
+
+    riscvP riscv = ma->riscv;
+
+    ma->fields   = segment & 0xff;
+    ma->fieldGap = (segment>>8) * riscv->configInfo.VLEN/8;
+    ma->segBytes = ma->fields * ma->EEW/8;
+    ma->contig   = !ma->vs2 && (ma->stride==ma->segBytes);
+}
+
+//
+// Transfer active segments of EEW-bit elements of register groups vd (and its
+// successors) to or from memory at base+i*stride for segment i (strided loads
+// and stores)
+//
+Uns32 riscvVKLdStS(
+    riscvP       riscv,
+    Uns32        vd,
+    Uns32        EEW,
+    Uns32        segment,
+    riscvVKFlags flags,
+    Uns32        vstart,
+    Uns32        vl,
+    Uns64        base,
+    Uns64        stride,
+    Uns64        addrMask
+) {
+    vkMemAccess ma = {
+        riscv    : riscv,
+        domain   : vmirtGetProcessorDataDomain((vmiProcessorP)riscv),
+        vd       : getVRegBytes(riscv, vd),
+        EEW      : EEW,
+        flags    : flags,
+        base     : base,
+        stride   : stride,
+        addrMask : addrMask
+    };
+
+    setSegment(&ma, segment);
+
+    return accessMemory(&ma, vstart, vl);
+}
+
+//
+// Transfer active segments of EEW-bit elements of register groups vd (and its
+// successors) to or from memory at base plus IEEW-bit element i of register
+// group vs2 for segment i (indexed loads and stores)
+//
+Uns32 riscvVKLdStI(
+    riscvP       riscv,
+    Uns32        vd,
+    Uns32        vs2,
+    Uns32        EEW,
+    Uns32        IEEW,
+    Uns32        segment,
+    riscvVKFlags flags,
+    Uns32        vstart,
+    Uns32        vl,
+    Uns64        base,
+    Uns64        addrMask
+) {
+    vkMemAccess ma = {
+        riscv    : riscv,
+        domain   : vmirtGetProcessorDataDomain((vmiProcessorP)riscv),
+        vd       : getVRegBytes(riscv, vd),
+        vs2      : getVRegBytes(riscv, vs2),
+        EEW      : EEW,
+        IEEW     : IEEW,
+        flags    : flags,
+        base     : base,
+        addrMask : addrMask
+    };
+
+    setSegment(&ma, segment);
+
+    return accessMemory(&ma, vstart, vl);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// TAIL AND MASKED-OFF ELEMENT KERNELS
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Set masked-off elements of SEW-bit register group vd in range [vstart,vl)
+// to all-ones (vtype.vma=1 with agnostic_ones)
+//
+void riscvVKFillMaskedOff(
+    riscvP riscv,
+    Uns32  vd,
+    Uns32  SEW,
+    Uns32  vstart,
+    Uns32  vl
+) {
+    riscvVKFlags flags = RVVK_MASKED|RVVK_VMA1;
+
+    fillMaskedOff(riscv, getVRegBytes(riscv, vd), SEW, flags, vstart, vl);
+}
+
+//
+// Set tail elements [vstart,end) of the SEW-bit register groups of segment
+// fields selected by bitmask fields to all-ones or all-zeros, where the groups
+// are at register index offsets of EMUL from vd
+//
+void riscvVKFillTail(
+    riscvP riscv,
+    Uns32  vd,
+    Uns32  SEW,
+    Uns32  EMUL,
+    Uns32  fields,
+    Uns32  vstart,
+    Uns32  end,
+    Bool   ones
+) {
+    if(vstart<end) {
+
+        Uns32 bytes = (end-vstart)*(SEW/8);
+
+        while(fields) {
+
+            Uns32 f   = __builtin_ctz(fields);
+            Uns8 *vdB = getVRegBytes(riscv, vd+f*EMUL);
+
+            memset(getElementPtr(vdB, SEW, vstart), ones ? -1 : 0, bytes);
+
+            fields &= fields-1;
+        }
+    }
+}
+
+//
+// Set tail bits [vstart,end) of mask register vd to all-ones or all-zeros
+//
+void riscvVKFillMaskTail(
+    riscvP riscv,
+    Uns32  vd,
+    Uns32  vstart,
+    Uns32  end,
+    Bool   ones
+) {
+    Uns64 *vdW  = getVRegWords(riscv, vd);
+    Uns32  wEnd = getWordEnd(vstart, end);
+    Uns32  w;
+
+    for(w=getWordStart(vstart); w<wEnd; w++) {
+
+        Uns64 update = getRangeMask(w, vstart, end);
+
+        if(ones) {
+            vdW[w] |= update;
+        } else {
+            vdW[w] &= ~update;
+        }
+    }
+}
@@ -0,0 +1,377 @@
+/*
+ * Copyright (c) 2005-2023 Imperas Software Ltd., www.imperas.com
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+// VMI header files
+#include "vmi/vmiTypes.h"
+
+// model header files
+#include "riscvTypeRefs.h"
+
+//
+// These functions implement entire vector instructions on host copies of the
+// vector register file. They are called from JIT code only when operands are
+// laid out contiguously (MLEN=1, SLEN=VLEN and VLEN a multiple of 64), so
+// that mask register bit i is bit i%64 of 64-bit word i/64 and element i of a
+// register group is at byte offset i*EEW/8. Elements in the range [vstart,vl)
+// are processed; tail elements are handled by the caller.
+//
+
+//
+// Flags modifying bulk kernel behavior
+//
+typedef enum riscvVKFlagsE {
+    RVVK_MASKED = 0x1,      // operation is masked by v0
+    RVVK_VMA1   = 0x2,      // masked-off destination elements are set to 1
+    RVVK_WIDEN  = 0x4,      // reduction accumulates at twice source width
+    RVVK_SIGNED = 0x8,      // reduction source or index elements are signed
+    RVVK_STORE  = 0x10,     // memory access is a store
+    RVVK_BCAST  = 0x20,     // zero-stride load need be performed only once
+} riscvVKFlags;
+
+//
+// This enumerates set-before/including/only-first operations
+//
+typedef enum riscvVKFirstOpE {
+    RVVK_SBF,               // vmsbf.m
+    RVVK_SIF,               // vmsif.m
+    RVVK_SOF,               // vmsof.m
+} riscvVKFirstOp;
+
+//
+// This enumerates integer reduction operations
+//
+typedef enum riscvVKRedOpE {
+    RVVK_RSUM,              // vredsum.vs, vwredsum.vs and vwredsumu.vs
+    RVVK_RAND,              // vredand.vs
+    RVVK_ROR,               // vredor.vs
+    RVVK_RXOR,              // vredxor.vs
+    RVVK_RMINU,             // vredminu.vs
+    RVVK_RMIN,              // vredmin.vs
+    RVVK_RMAXU,             // vredmaxu.vs
+    RVVK_RMAX,              // vredmax.vs
+} riscvVKRedOp;
+
+//
+// This enumerates floating point element operations (a, b and c are operands)
+//
+typedef enum riscvVKFltOpE {
+    RVVK_FADD,              // a+b
+    RVVK_FSUB,              // a-b
+    RVVK_FMUL,              // a*b
+    RVVK_FDIV,              // a/b
+    RVVK_FSQRT,             // sqrt(a)
+    RVVK_FMADD,             // (a*b)+c
+    RVVK_FNMADD,            // -(a*b)-c
+    RVVK_FMSUB,             // (a*b)-c
+    RVVK_FNMSUB,            // -(a*b)+c
+} riscvVKFltOp;
+
+//
+// Pack destination and operand register indices for riscvVKFlt (operands not
+// in vector registers are given as RVVK_FSCALAR)
+//
+#define RVVK_FREGS(_D, _A, _B, _C) ((_D) | ((_A)<<8) | ((_B)<<16) | ((_C)<<24))
+#define RVVK_FSCALAR               0xff
+
+//
+// Return count of active set bits in mask register vs2 (vcpop.m)
+//
+Uns64 riscvVKCPop(
+    riscvP       riscv,
+    Uns32        vs2,
+    riscvVKFlags flags,
+    Uns32        vstart,
+    Uns32        vl
+);
+
+//
+// Return index of first active set bit in mask register vs2, or -1 (vfirst.m)
+//
+Uns64 riscvVKFirst(
+    riscvP       riscv,
+    Uns32        vs2,
+    riscvVKFlags flags,
+    Uns32        vstart,
+    Uns32        vl
+);
+
+//
+// Set mask register vd before, including or only the first active set bit in
+// mask register vs2 (vmsbf.m, vmsif.m and vmsof.m)
+//
+void riscvVKSetFirst(
+    riscvP         riscv,
+    Uns32          vd,
+    Uns32          vs2,
+    riscvVKFirstOp type,
+    riscvVKFlags   flags,
+    Uns32          vstart,
+    Uns32          vl
+);
+
+//
+// Set each active element of SEW-bit register group vd to the count of active
+// set bits in mask register vs2 at lower indices (viota.m)
+//
+void riscvVKIota(
+    riscvP       riscv,
+    Uns32        vd,
+    Uns32        vs2,
+    Uns32        SEW,
+    riscvVKFlags flags,
+    Uns32        vstart,
+    Uns32        vl
+);
+
+//
+// Slide elements of register group vs2 up by offset into vd (vslideup)
+//
+void riscvVKSlideUp(
+    riscvP       riscv,
+    Uns32        vd,
+    Uns32        vs2,
+    Uns32        SEW,
+    riscvVKFlags flags,
+    Uns32        vstart,
+    Uns32        vl,
+    Uns64        offset
+);
+
+//
+// Slide elements of register group vs2 down by offset into vd, with elements
+// from at or beyond vlmax taken as zero (vslidedown)
+//
+void riscvVKSlideDown(
+    riscvP       riscv,
+    Uns32        vd,
+    Uns32        vs2,
+    Uns32        SEW,
+    riscvVKFlags flags,
+    Uns32        vstart,
+    Uns32        vl,
+    Uns32        vlmax,
+    Uns64        offset
+);
+
+//
+// Slide elements of register group vs2 up by one into vd, inserting value at
+// element 0 (vslide1up and vfslide1up)
+//
+void riscvVKSlide1Up(
+    riscvP       riscv,
+    Uns32        vd,
+    Uns32        vs2,
+    Uns32        SEW,
+    riscvVKFlags flags,
+    Uns32        vstart,
+    Uns32        vl,
+    Uns64        value
+);
+
+//
+// Slide elements of register group vs2 down by one into vd, inserting value at
+// element vl-1 (vslide1down and vfslide1down)
+//
+void riscvVKSlide1Down(
+    riscvP       riscv,
+    Uns32        vd,
+    Uns32        vs2,
+    Uns32        SEW,
+    riscvVKFlags flags,
+    Uns32        vstart,
+    Uns32        vl,
+    Uns64        value
+);
+
+//
+// Set active elements of register group vd to the element of vs2 selected by
+// the given index, or zero if the index is at or beyond vlmax (vrgather.vx
+// and vrgather.vi)
+//
+void riscvVKGatherX(
+    riscvP       riscv,
+    Uns32        vd,
+    Uns32        vs2,
+    Uns32        SEW,
+    riscvVKFlags flags,
+    Uns32        vstart,
+    Uns32        vl,
+    Uns32        vlmax,
+    Uns64        index
+);
+
+//
+// Set active elements of register group vd to the element of vs2 selected by
+// the corresponding EEW-bit element of vs1, or zero if that index is at or
+// beyond vlmax (vrgather.vv and vrgatherei16.vv)
+//
+void riscvVKGatherV(
+    riscvP       riscv,
+    Uns32        vd,
+    Uns32        vs2,
+    Uns32        vs1,
+    Uns32        SEW,
+    Uns32        EEW,
+    riscvVKFlags flags,
+    Uns32        vstart,
+    Uns32        vl,
+    Uns32        vlmax
+);
+
+//
+// Pack elements of register group vs2 selected by mask register vs1 into
+// consecutive elements of vd (vcompress.vm)
+//
+void riscvVKCompress(
+    riscvP riscv,
+    Uns32  vd,
+    Uns32  vs2,
+    Uns32  vs1,
+    Uns32  SEW,
+    Uns32  vstart,
+    Uns32  vl
+);
+
+//
+// Return the result of combining accumulator acc with active SEW-bit elements
+// of register group vs2 using the given integer reduction operation
+//
+Uns64 riscvVKRedInt(
+    riscvP       riscv,
+    Uns32        vs2,
+    Uns32        SEW,
+    riscvVKRedOp op,
+    riscvVKFlags flags,
+    Uns32        vstart,
+    Uns32        vl,
+    Uns64        acc
+);
+
+//
+// Apply floating point operation op to active SEW-bit elements, where operands
+// and destination are packed by RVVK_FREGS and any scalar operand has value
+// scalar. Only round-to-nearest-even is implemented, and elements from the
+// first run of active elements that would produce a NaN result are not
+// processed, so that the caller can complete the operation element by element.
+// Returns the index of the first unprocessed element (vl if all elements were
+// processed) in bits 31:0 and the vmiFPFlags raised by processed elements in
+// bits 39:32
+//
+Uns64 riscvVKFlt(
+    riscvP       riscv,
+    riscvVKFltOp op,
+    Uns32        SEW,
+    riscvVKFlags flags,
+    Uns32        vstart,
+    Uns32        vl,
+    Uns32        regs,
+    Uns64        scalar
+);
+
+//
+// Pack segment layout for riscvVKLdStS and riscvVKLdStI, giving the number of
+// fields in each segment and the register index offset between the register
+// groups holding consecutive fields
+//
+#define RVVK_SEGMENT(_FIELDS, _EMUL) ((_FIELDS) | ((_EMUL)<<8))
+
+//
+// Transfer active segments of EEW-bit elements of register groups vd (and its
+// successors, as given by segment) to or from memory at base+i*stride for
+// segment i (strided loads and stores). Segment fields are contiguous in
+// memory. Calculated addresses are masked by addrMask. Segments in pages of
+// plain memory are copied directly; misaligned segments, those following an
+// access that fails and those following the first segment in a page that is
+// not plain memory are not processed, so that the caller can complete the
+// operation element by element. Returns the index of the first unprocessed
+// segment (vl if all segments were processed)
+//
+Uns32 riscvVKLdStS(
+    riscvP       riscv,
+    Uns32        vd,
+    Uns32        EEW,
+    Uns32        segment,
+    riscvVKFlags flags,
+    Uns32        vstart,
+    Uns32        vl,
+    Uns64        base,
+    Uns64        stride,
+    Uns64        addrMask
+);
+
+//
+// Transfer active segments of EEW-bit elements of register groups vd (and its
+// successors) to or from memory at base plus IEEW-bit element i of register
+// group vs2 for segment i (indexed loads and stores), otherwise as riscvVKLdStS
+//
+Uns32 riscvVKLdStI(
+    riscvP       riscv,
+    Uns32        vd,
+    Uns32        vs2,
+    Uns32        EEW,
+    Uns32        IEEW,
+    Uns32        segment,
+    riscvVKFlags flags,
+    Uns32        vstart,
+    Uns32        vl,
+    Uns64        base,
+    Uns64        addrMask
+);
+
+//
+// Set masked-off elements of SEW-bit register group vd in range [vstart,vl)
+// to all-ones (vtype.vma=1 with agnostic_ones)
+//
+void riscvVKFillMaskedOff(
+    riscvP riscv,
+    Uns32  vd,
+    Uns32  SEW,
+    Uns32  vstart,
+    Uns32  vl
+);
+
+//
+// Set tail elements [vstart,end) of the SEW-bit register groups of segment
+// fields selected by bitmask fields to all-ones or all-zeros, where the groups
+// are at register index offsets of EMUL from vd
+//
+void riscvVKFillTail(
+    riscvP riscv,
+    Uns32  vd,
+    Uns32  SEW,
+    Uns32  EMUL,
+    Uns32  fields,
+    Uns32  vstart,
+    Uns32  end,
+    Bool   ones
+);
+
+//
+// Set tail bits [vstart,end) of mask register vd to all-ones or all-zeros
+//
+void riscvVKFillMaskTail(
+    riscvP riscv,
+    Uns32  vd,
+    Uns32  vstart,
+    Uns32  end,
+    Bool   ones
+);
+